@@ -3,11 +3,7 @@
 
 #include "BTService_Fire.h"
 #include "AIController.h"
-#include "Actors/Equipment/Weapons/RangeWeaponItem.h"
-#include "AI/Characters/GCAICharacter.h"
-#include "BehaviorTree/BlackboardComponent.h"
-#include "Components/CharacterComponents/CharacterAttributesComponent.h"
-#include "Components/CharacterComponents/CharacterEquipmentComponent.h"
+#include "Subsystems/AIThinkBudgetSubsystem.h"
 //#include "XMPP/Public/XmppMultiUserChat.h"
 
 UBTService_Fire::UBTService_Fire()
@@ -19,43 +15,12 @@ void UBTService_Fire::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMem
 {
 	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
 
+	// Decision itself is made by the think budget, at most MaxThinksPerFrame agents a frame
 	AAIController* AIController = OwnerComp.GetAIOwner();
-	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
-	if (!IsValid(AIController) || !IsValid(Blackboard))
+	if (!IsValid(AIController))
 	{
 		return;
 	}
 
-	AGCBaseCharacter* Character = Cast<AGCBaseCharacter>(AIController->GetPawn());
-	UCharacterAttributesComponent* CharacterAttributes = Character->GetCharacterAttributesComponent();
-	if (!IsValid(Character) || !CharacterAttributes->IsAlive())
-	{
-		return;
-	}
-
-	const UCharacterEquipmentComponent* EquipmentComponent = Character->GetCharacterEquipmentComponent();
-	ARangeWeaponItem* RangeWeapon = EquipmentComponent->GetCurrentRangeWeapon();
-	if (!IsValid(RangeWeapon))
-	{
-		return;
-	}
-
-	AActor* CurrentTarget = Cast<AActor>(Blackboard->GetValueAsObject(TargetKey.SelectedKeyName));
-	if (!IsValid(CurrentTarget))
-	{
-		Character->StopFire();
-		return;
-	}
-
-	float DistSq = FVector::DistSquared(CurrentTarget->GetActorLocation(), Character->GetActorLocation());
-	if (DistSq > FMath::Square(MaxFireDistance))
-	{
-		Character->StopFire();
-		return;
-	}
-
-	if (!(RangeWeapon->IsReloading() || RangeWeapon->IsFiring()))
-	{
-		Character->StartFire();
-	}
+	AIController->GetWorld()->GetSubsystem<UAIThinkBudgetSubsystem>()->RequestFireThink(AIController, TargetKey.SelectedKeyName, MaxFireDistance);
 }
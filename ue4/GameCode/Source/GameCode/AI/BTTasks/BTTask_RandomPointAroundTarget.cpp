@@ -4,8 +4,9 @@
 #include "BTTask_RandomPointAroundTarget.h"
 
 #include "AIController.h"
-#include "NavigationSystem.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Subsystems/CombatSnapshotSubsystem.h"
+#include "Subsystems/NavSamplingSubsystem.h"
 
 UBTTask_RandomPointAroundTarget::UBTTask_RandomPointAroundTarget()
 {
@@ -27,25 +28,66 @@ EBTNodeResult::Type UBTTask_RandomPointAroundTarget::ExecuteTask(UBehaviorTreeCo
 		return  EBTNodeResult::Failed;
 	}
 
-	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(Pawn);
-	if (!IsValid(NavSys))
+	const AActor* TargetActor = nullptr;
+	FVector TargetLocation = FVector::ZeroVector;
+	const UCombatSnapshotSubsystem* CombatSnapshotSubsystem = Pawn->GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>();
+	int32 TargetIndex = CombatSnapshotSubsystem->FindTargetIndex(AIController, TargetKey.SelectedKeyName);
+	if (TargetIndex != INDEX_NONE)
 	{
-		return  EBTNodeResult::Failed;
+		TargetActor = CombatSnapshotSubsystem->GetSnapshot().Pawns[TargetIndex];
+		TargetLocation = CombatSnapshotSubsystem->GetSnapshot().Locations[TargetIndex];
+	}
+	else
+	{
+		TargetActor = Cast<AActor>(Blackboard->GetValueAsObject(TargetKey.SelectedKeyName));
+		if (!IsValid(TargetActor))
+		{
+			return  EBTNodeResult::Failed;
+		}
+		TargetLocation = TargetActor->GetActorLocation();
 	}
 
-	AActor* TargetActor = Cast<AActor>(Blackboard->GetValueAsObject(TargetKey.SelectedKeyName));
-	if (!IsValid(TargetActor))
+	UNavSamplingSubsystem* NavSamplingSubsystem = Pawn->GetWorld()->GetSubsystem<UNavSamplingSubsystem>();
+	FVector Point;
+	if (NavSamplingSubsystem->TryTakePoint(TargetActor, TargetLocation, Radius, Point))
 	{
-		return  EBTNodeResult::Failed;
+		Blackboard->SetValueAsVector(LocationKey.SelectedKeyName, Point);
+		return EBTNodeResult::Succeeded;
 	}
 
-	FNavLocation NavLocation;
-	bool bIsFound = NavSys->GetRandomReachablePointInRadius(TargetActor->GetActorLocation(), Radius, NavLocation);
-	if (!bIsFound)
+	// Pool around the target is empty, the task finishes once it's refilled
+	FBTRandomPointAroundTargetMemory* Memory = CastInstanceNodeMemory<FBTRandomPointAroundTargetMemory>(NodeMemory);
+	FOnNavPointSampled Callback = FOnNavPointSampled::CreateUObject(this, &UBTTask_RandomPointAroundTarget::OnPointSampled, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp));
+	Memory->RequestId = NavSamplingSubsystem->RequestPoint(TargetActor, TargetLocation, Radius, Callback);
+	return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UBTTask_RandomPointAroundTarget::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTRandomPointAroundTargetMemory* Memory = CastInstanceNodeMemory<FBTRandomPointAroundTargetMemory>(NodeMemory);
+	OwnerComp.GetWorld()->GetSubsystem<UNavSamplingSubsystem>()->CancelRequest(Memory->RequestId);
+	Memory->RequestId = 0;
+	return EBTNodeResult::Aborted;
+}
+
+uint16 UBTTask_RandomPointAroundTarget::GetInstanceMemorySize() const
+{
+	return sizeof(FBTRandomPointAroundTargetMemory);
+}
+
+void UBTTask_RandomPointAroundTarget::OnPointSampled(bool bIsFound, const FVector& Point, TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp)
+{
+	if (!OwnerComp.IsValid())
 	{
-		return  EBTNodeResult::Failed;
+		return;
 	}
 
-	Blackboard->SetValueAsVector(LocationKey.SelectedKeyName, NavLocation.Location);
-	return EBTNodeResult::Succeeded;
+	UBlackboardComponent* Blackboard = OwnerComp->GetBlackboardComponent();
+	if (bIsFound && IsValid(Blackboard))
+	{
+		Blackboard->SetValueAsVector(LocationKey.SelectedKeyName, Point);
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Succeeded);
+		return;
+	}
+	FinishLatentTask(*OwnerComp, EBTNodeResult::Failed);
 }
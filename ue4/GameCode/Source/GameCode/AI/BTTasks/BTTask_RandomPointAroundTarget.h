@@ -6,6 +6,11 @@
 #include "BehaviorTree/BTTaskNode.h"
 #include "BTTask_RandomPointAroundTarget.generated.h"
 
+struct FBTRandomPointAroundTargetMemory
+{
+	uint32 RequestId = 0;
+};
+
 /**
  * 
  */
@@ -17,6 +22,8 @@ public:
 	UBTTask_RandomPointAroundTarget();
 
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override;
 
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
@@ -27,4 +34,7 @@ protected:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="AI")
 	FBlackboardKeySelector LocationKey;
+
+private:
+	void OnPointSampled(bool bIsFound, const FVector& Point, TWeakObjectPtr<UBehaviorTreeComponent> OwnerComp);
 };
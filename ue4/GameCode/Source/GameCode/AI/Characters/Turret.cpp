@@ -6,11 +6,14 @@
 #include "AIController.h"
 #include "AI/Controllers/AITurretController.h"
 #include "Components/Weapon/WeaponBarellComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "Subsystems/CombatSnapshotSubsystem.h"
+#include "Subsystems/ImpactFXSubsystem.h"
+#include "Subsystems/TurretAimSubsystem.h"
 
 ATurret::ATurret()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Aiming is done by UTurretAimSubsystem
+	PrimaryActorTick.bCanEverTick = false;
 
 	USceneComponent* TurretRoot = CreateDefaultSubobject<USceneComponent>(TEXT("TurretRoot"));
 	SetRootComponent(TurretRoot);
@@ -42,31 +45,20 @@ void ATurret::BeginPlay()
 	OnTakeAnyDamage.AddDynamic(this, &ATurret::OnTakeAnyDamageEvent);
 	OnDestroyedEvent.AddDynamic(this, &ATurret::OnDestroyed);
 	Health = MaxHealth;
+	GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>()->RegisterCombatant(this);
+
+	FTurretAimSettings AimSettings;
+	AimSettings.SearchingRotationRate = BaseSearchingRotationRate;
+	AimSettings.FiringInterpSpeed = BaseFiringInterpSpeed;
+	AimSettings.PitchRotationRate = BarellPitchRotationRate;
+	GetWorld()->GetSubsystem<UTurretAimSubsystem>()->RegisterTurret(this, TurretBaseComponent, TurretBarellComponent, AimSettings);
 }
 
-void ATurret::Tick(float DeltaTime)
+void ATurret::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
-	
-	switch (CurrentTurretState)
-	{
-		case ETurretState::Searching:
-			{
-				SearchingMovement(DeltaTime);
-				break;
-			}
-		case ETurretState::Firing:
-			{
-				FiringMovement(DeltaTime);
-				break;
-			}
-		case ETurretState::Destroyed:
-			{
-				break;
-			}
-		default:
-			break;
-	}
+	GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>()->UnregisterCombatant(this);
+	GetWorld()->GetSubsystem<UTurretAimSubsystem>()->UnregisterTurret(this);
+	Super::EndPlay(EndPlayReason);
 }
 
 void ATurret::SetCurrentTarget(AActor* NewTarget)
@@ -78,12 +70,12 @@ void ATurret::SetCurrentTarget(AActor* NewTarget)
 
 FVector ATurret::GetPawnViewLocation() const
 {
-	return WeaponBarell->GetComponentLocation();
+	return GetViewTransform().GetLocation();
 }
 
 FRotator ATurret::GetViewRotation() const
 {
-	return WeaponBarell->GetComponentRotation();
+	return GetViewTransform().Rotator();
 }
 
 void ATurret::OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
@@ -94,12 +86,11 @@ void ATurret::OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const UDa
 		return;
 	}
 
-	UE_LOG(LogDamage, Warning, TEXT("ATurret::OnTakeAnyDamage %s recieved %.2f amount of damage from %s"), *GetName(), Damage, *DamageCauser->GetName());
 	Health = FMath::Clamp(Health - Damage, 0.f, MaxHealth); 
 	
 	if (Health <= 0.f)
 	{
-		UE_LOG(LogDamage, Warning, TEXT("ATurret::OnTakeAnyDamage character %s is killed by: %s"), *GetName(), *DamageCauser->GetName());
+		UE_LOG(LogDamage, Verbose, TEXT("ATurret::OnTakeAnyDamage character %s is killed by: %s"), *GetName(), *GetNameSafe(DamageCauser));
 		if (OnDestroyedEvent.IsBound())
 		{
 			OnDestroyedEvent.Broadcast();
@@ -109,32 +100,6 @@ void ATurret::OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const UDa
 	//TakeDamage(Damage, FDamageEvent(), GetController(), DamageCauser);
 }
 
-void ATurret::SearchingMovement(float DeltaTime)
-{
-	FRotator TurretBaseRotation = TurretBaseComponent->GetRelativeRotation();
-	TurretBaseRotation.Yaw += BaseSearchingRotationRate * DeltaTime;
-	TurretBaseComponent->SetRelativeRotation(TurretBaseRotation);
-
-	FRotator TurretBarellRotation = TurretBarellComponent->GetRelativeRotation();
-	TurretBarellRotation.Pitch = FMath::FInterpTo(TurretBarellRotation.Pitch, 0.f, DeltaTime, BarellPitchRotationRate);
-	TurretBarellComponent->SetRelativeRotation(TurretBarellRotation);
-}
-
-void ATurret::FiringMovement(float DeltaTime)
-{
-	FVector BaseLookAtDirection = (CurrentTarget->GetActorLocation() - TurretBaseComponent->GetComponentLocation()).GetSafeNormal2D();
-	FQuat LookAtQuat = BaseLookAtDirection.ToOrientationQuat();
-	FQuat TargetQuat = FMath::QInterpTo(TurretBaseComponent->GetComponentQuat(), LookAtQuat, DeltaTime, BaseFiringInterpSpeed);
-	TurretBaseComponent->SetWorldRotation(TargetQuat);
-
-	FVector BarellLookAtDirection = (CurrentTarget->GetActorLocation() - TurretBarellComponent->GetComponentLocation()).GetSafeNormal();
-	float BarellLookAtPitchAngle = BarellLookAtDirection.ToOrientationRotator().Pitch;
-	
-	FRotator BarellLocalRotation = TurretBarellComponent->GetRelativeRotation();
-	BarellLocalRotation.Pitch = FMath::FInterpTo(BarellLocalRotation.Pitch, BarellLookAtPitchAngle, DeltaTime, BarellPitchRotationRate);
-	TurretBarellComponent->SetRelativeRotation(BarellLocalRotation);
-}
-
 void ATurret::MakeShot()
 {
 	FVector ShotLocation = WeaponBarell->GetComponentLocation();
@@ -179,11 +144,19 @@ float ATurret::GetFireInterval() const
 
 void ATurret::OnDestroyed()
 {
-	//SpawnEmitter
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), DestroyFX, GetActorTransform());
+	GetWorld()->GetSubsystem<UImpactFXSubsystem>()->SpawnParticleSystem(DestroyFX, GetActorTransform());
 	SetCurrentTurretState(ETurretState::Destroyed);
 	GetController()->Destroy();
-	UE_LOG(LogDamage, Warning, TEXT("ATurret::OnTakeAnyDamage character %s is killed"), *GetName());
 }
 
-
+FTransform ATurret::GetViewTransform() const
+{
+	UWorld* World = GetWorld();
+	const UTurretAimSubsystem* TurretAimSubsystem = IsValid(World) ? World->GetSubsystem<UTurretAimSubsystem>() : nullptr;
+	FTransform Result;
+	if (IsValid(TurretAimSubsystem) && TurretAimSubsystem->GetAimedTransform(this, WeaponBarell, Result))
+	{
+		return Result;
+	}
+	return WeaponBarell->GetComponentTransform();
+}
@@ -30,8 +30,7 @@ public:
 	virtual void PossessedBy(AController* NewController) override;
 
 	virtual void BeginPlay() override;
-	
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	void SetCurrentTarget(AActor* NewTarget);
 
@@ -43,6 +42,12 @@ public:
 	FOnDestroyedEventSignature OnDestroyedEvent;
 
 	bool IsDestroyed() const { return CurrentTurretState == ETurretState::Destroyed ? true : false; };
+
+	bool IsFiring() const { return CurrentTurretState == ETurretState::Firing; }
+
+	AActor* GetCurrentTarget() const { return CurrentTarget; }
+
+	ETeams GetTeam() const { return Team; }
 	
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
@@ -94,9 +99,6 @@ protected:
 	void OnDestroyed();
 	
 private:
-	void SearchingMovement(float DeltaTime);
-	void FiringMovement(float DeltaTime);
-
 	void MakeShot();
 	
 	ETurretState CurrentTurretState = ETurretState::Searching;
@@ -105,6 +107,9 @@ private:
 	AActor* CurrentTarget = nullptr;
 
 	float GetFireInterval() const;
+
+	// Barell of a searching turret nobody sees isn't moved, perception looks along its aim state instead
+	FTransform GetViewTransform() const;
 	
 	FTimerHandle ShotTimer;
 
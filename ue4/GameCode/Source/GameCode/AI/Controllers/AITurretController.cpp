@@ -15,7 +15,6 @@ void AAITurretController::SetPawn(APawn* InPawn)
 	{
 		checkf(InPawn->IsA<ATurret>(), TEXT("void AAITurretController::SetPawn(APawn* InPawn) AITurretController can be used only with ATurret"));
 		CachedTurret = StaticCast<ATurret*>(InPawn);
-		CachedTurret->OnTakeAnyDamage.AddDynamic(this, &AAITurretController::OnTakeAnyDamageEvent);
 	}
 	else
 	{
@@ -30,22 +29,18 @@ void AAITurretController::ActorsPerceptionUpdated(const TArray<AActor*>& Updated
 		return;
 	}
 	
-	AActor* ClosestActor = GetClosestSensedActor(UAISense_Damage::StaticClass());
-	if (ClosestActor)
+	RequestClosestSensedActor({ UAISense_Damage::StaticClass(), UAISense_Sight::StaticClass() });
+}
+
+void AAITurretController::OnClosestSensedActorResolved(AActor* ClosestActor, TSubclassOf<UAISense> SenseClass)
+{
+	if (!CachedTurret.IsValid() || CachedTurret->IsDestroyed())
 	{
-		CachedTurret->SetCurrentTarget(ClosestActor);
 		return;
 	}
-	
-	ClosestActor = GetClosestSensedActor(UAISense_Sight::StaticClass());	
+
 	if (ClosestActor)
 	{
 		CachedTurret->SetCurrentTarget(ClosestActor);
 	}
 }
-
-void AAITurretController::OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
-	AController* InstigatedBy, AActor* DamageCauser)
-{
-	UAISense_Damage::ReportDamageEvent(GetWorld(), DamagedActor, DamageCauser, Damage, DamageCauser->GetActorLocation(), DamagedActor->GetActorLocation());
-}
\ No newline at end of file
@@ -20,10 +20,8 @@ public:
 
 	virtual void ActorsPerceptionUpdated(const TArray<AActor*>& UpdatedActors) override;
 
-protected:
-	UFUNCTION()
-	void OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
-	
+	virtual void OnClosestSensedActorResolved(AActor* ClosestActor, TSubclassOf<UAISense> SenseClass) override;
+
 private:
 	TWeakObjectPtr<ATurret> CachedTurret;
 };
\ No newline at end of file
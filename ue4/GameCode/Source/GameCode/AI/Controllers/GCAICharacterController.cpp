@@ -7,6 +7,8 @@
 #include "GameCodeTypes.h"
 #include "Perception/AISense_Damage.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogAICharacterController, Display, Display)
+
 void AGCAICharacterController::SetPawn(APawn* InPawn)
 {
 	Super::SetPawn(InPawn);
@@ -15,7 +17,6 @@ void AGCAICharacterController::SetPawn(APawn* InPawn)
 		checkf(InPawn->IsA<AGCAICharacter>(), TEXT("void AGCAICharacterController::SetPawn(APawn* InPawn) GCAICherecterController can be used only with AICharacter"));
 		CachedAICharacter = StaticCast<AGCAICharacter*>(InPawn);
 		RunBehaviorTree(CachedAICharacter->GetBehaviorTree());
-		CachedAICharacter->OnTakeAnyDamage.AddDynamic(this, &AGCAICharacterController::OnTakeAnyDamageEvent);
 	}
 	else
 	{
@@ -30,7 +31,7 @@ void AGCAICharacterController::ActorsPerceptionUpdated(const TArray<AActor*>& Up
 	{
 		return;
 	}
-	UE_LOG(LogTemp, Warning, TEXT("ActorsPerceptionUpdated"));
+	UE_LOG(LogAICharacterController, Verbose, TEXT("%s perception updated, %d actors"), *GetName(), UpdatedActors.Num());
 	TryMoveToNextTarget();
 }
 
@@ -60,19 +61,15 @@ void AGCAICharacterController::BeginPlay()
 	}
 }
 
-void AGCAICharacterController::OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const UDamageType* DamageType,
-	AController* InstigatedBy, AActor* DamageCauser)
-{
-	UAISense_Damage::ReportDamageEvent(GetWorld(), DamagedActor, DamageCauser, Damage, DamageCauser->GetActorLocation(), DamagedActor->GetActorLocation());
-	//TryMoveToNextTarget();
-}
-
-void AGCAICharacterController::TryMoveToNextTarget()
+void AGCAICharacterController::OnClosestSensedActorResolved(AActor* ClosestActor, TSubclassOf<UAISense> SenseClass)
 {
-	AActor* ClosestActor = GetClosestSensedActor(UAISense_Sight::StaticClass());
+	if (!CachedAICharacter.IsValid())
+	{
+		return;
+	}
 	UAIPatrollingComponent* PatrollingComponent = CachedAICharacter->GetAIPatrollingComponent();
 	
-	if (IsValid(ClosestActor))
+	if (IsValid(ClosestActor) && SenseClass == UAISense_Sight::StaticClass())
 	{
 		if (IsValid(Blackboard))
 		{
@@ -83,20 +80,16 @@ void AGCAICharacterController::TryMoveToNextTarget()
 		}
 		bIsPatrolling = false;
 	}
-	else
+	else if (IsValid(ClosestActor))
 	{
-		ClosestActor = GetClosestSensedActor(UAISense_Damage::StaticClass());
-		if (IsValid(ClosestActor))
+		if (IsValid(Blackboard))
 		{
-			if (IsValid(Blackboard))
-			{
-				ClearFocus(EAIFocusPriority::Gameplay);
-				Blackboard->SetValueAsBool(BB_bForceMove, true);
-				Blackboard->SetValueAsVector(BB_NextLocation, ClosestActor->GetActorLocation());
-				Blackboard->SetValueAsObject(BB_CurrentTarget, nullptr);
-			}
-			bIsPatrolling = false;
+			ClearFocus(EAIFocusPriority::Gameplay);
+			Blackboard->SetValueAsBool(BB_bForceMove, true);
+			Blackboard->SetValueAsVector(BB_NextLocation, ClosestActor->GetActorLocation());
+			Blackboard->SetValueAsObject(BB_CurrentTarget, nullptr);
 		}
+		bIsPatrolling = false;
 	}
 	
 	if (PatrollingComponent->CanPatrol() && !IsValid(ClosestActor))
@@ -113,6 +106,11 @@ void AGCAICharacterController::TryMoveToNextTarget()
 	}
 }
 
+void AGCAICharacterController::TryMoveToNextTarget()
+{
+	RequestClosestSensedActor({ UAISense_Sight::StaticClass(), UAISense_Damage::StaticClass() });
+}
+
 bool AGCAICharacterController::IsTargetReached(FVector TargetLocation) const
 {
 	return (TargetLocation - CachedAICharacter->GetActorLocation()).SizeSquared() <= FMath::Square(TargetReachRadius);
@@ -21,6 +21,8 @@ public:
 	virtual void ActorsPerceptionUpdated(const TArray<AActor*>& UpdatedActors) override;
 
 	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
+
+	virtual void OnClosestSensedActorResolved(AActor* ClosestActor, TSubclassOf<UAISense> SenseClass) override;
 	
 protected:
 	virtual void BeginPlay() override;
@@ -28,9 +30,6 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category= "Movement")
 	float TargetReachRadius = 100.f;
 
-	UFUNCTION()
-	void OnTakeAnyDamageEvent(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
-
 private:
 	void TryMoveToNextTarget();
 	bool IsTargetReached(FVector TargetLocation) const;
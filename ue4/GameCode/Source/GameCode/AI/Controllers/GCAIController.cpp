@@ -4,33 +4,18 @@
 #include "GCAIController.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISense_Damage.h"
+#include "Subsystems/PerceptionQuerySubsystem.h"
 
 AGCAIController::AGCAIController()
 {
 	PerceptionComponent = CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("AIPerception"));
 }
 
-AActor* AGCAIController::GetClosestSensedActor(TSubclassOf<UAISense> SenseClass) const
+void AGCAIController::RequestClosestSensedActor(const TArray<TSubclassOf<UAISense>>& SenseClasses)
 {
 	if (!IsValid(GetPawn()))
 	{
-		return nullptr;
+		return;
 	}
-	TArray<AActor*> SensedActors;
-	PerceptionComponent->GetCurrentlyPerceivedActors(SenseClass, SensedActors);
-
-	AActor* ClosestActor = nullptr;
-	float MinSquaredDistance = FLT_MAX;
-	FVector TurretLocation = GetPawn()->GetActorLocation();
-
-	for (AActor* SensedActor : SensedActors)
-	{
-		float CurrentSquaredDistance = (TurretLocation - SensedActor->GetActorLocation()).SizeSquared();
-		if (CurrentSquaredDistance < MinSquaredDistance)
-		{
-			MinSquaredDistance = CurrentSquaredDistance;
-			ClosestActor = SensedActor;
-		}
-	}
-	return ClosestActor;
-}
\ No newline at end of file
+	GetWorld()->GetSubsystem<UPerceptionQuerySubsystem>()->RequestClosestSensedActor(this, SenseClasses);
+}
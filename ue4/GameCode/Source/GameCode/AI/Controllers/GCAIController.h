@@ -17,7 +17,11 @@ class GAMECODE_API AGCAIController : public AAIController
 	GENERATED_BODY()
 public:
 	AGCAIController();
+
+	// Called by UPerceptionQuerySubsystem at the end of the frame, ClosestActor is nullptr if none of the requested senses perceive anything
+	virtual void OnClosestSensedActorResolved(AActor* ClosestActor, TSubclassOf<UAISense> SenseClass) {}
 	
 protected:
-	AActor* GetClosestSensedActor(TSubclassOf<UAISense> SenseClass) const;
+	// Senses are in priority order, the result comes to OnClosestSensedActorResolved
+	void RequestClosestSensedActor(const TArray<TSubclassOf<UAISense>>& SenseClasses);
 };
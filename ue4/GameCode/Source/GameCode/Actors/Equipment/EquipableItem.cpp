@@ -2,6 +2,8 @@
 
 
 #include "EquipableItem.h"
+#include "Animation/AnimMontage.h"
+#include "Subsystems/AssetStreamingSubsystem.h"
 
 
 
@@ -12,7 +14,7 @@ EEquipableItemType AEquipableItem::GetItemType() const
 
 UAnimMontage* AEquipableItem::GetCharacterEquipAnimMontage() const
 {
-	return CharacterEquipAnimMontage;
+	return GCAssetStreaming::GetOrLoadAsset(CharacterEquipAnimMontage);
 }
 
 FName AEquipableItem::GetUnequippedSocketName() const
@@ -24,3 +26,29 @@ FName AEquipableItem::GetEquippedSocketName() const
 {
 	return EquippedSocketName;
 }
+
+void AEquipableItem::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (!CharacterEquipAnimMontage.IsNull())
+	{
+		OutAssets.Add(CharacterEquipAnimMontage.ToSoftObjectPath());
+	}
+}
+
+void AEquipableItem::OnTakenFromPool(AActor* NewOwner)
+{
+	SetOwner(NewOwner);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+}
+
+void AEquipableItem::OnReturnedToPool()
+{
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	SetOwner(nullptr);
+	// Pooled item stays where its owner died, it mustn't block traces or overlaps there
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
@@ -21,12 +21,19 @@ public:
 	FName GetUnequippedSocketName() const;
 	FName GetEquippedSocketName() const;
 
+	// Soft referenced assets of the item, UCharacterEquipmentComponent streams them in before the item is equipped
+	virtual void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	// UEquipmentPoolSubsystem hides released items instead of destroying them, the state of the previous owner must not leak to the next one
+	virtual void OnTakenFromPool(AActor* NewOwner);
+	virtual void OnReturnedToPool();
+
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Equipable item")
 	EEquipableItemType ItemType = EEquipableItemType::None;
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Equipable item")
-	UAnimMontage* CharacterEquipAnimMontage;
+	TSoftObjectPtr<UAnimMontage> CharacterEquipAnimMontage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Equipable item")
 	FName UnequippedSocketName = NAME_None;
@@ -1,7 +1,9 @@
 #include "RangeWeaponItem.h"
+#include "Animation/AnimMontage.h"
 #include "Components/Weapon/WeaponBarellComponent.h"
 #include "GameCodeTypes.h"
 #include "Characters/GCBaseCharacter.h"
+#include "Subsystems/AssetStreamingSubsystem.h"
 
 ARangeWeaponItem::ARangeWeaponItem()
 {
@@ -53,10 +55,11 @@ void ARangeWeaponItem::StartReload()
 	}
 	bIsReloading = true;
 
-	if (IsValid(CharacterReloadMontage))
+	UAnimMontage* ReloadMontage = GCAssetStreaming::GetOrLoadAsset(CharacterReloadMontage);
+	if (IsValid(ReloadMontage))
 	{
-		float MontageDuration = CharacterOwner->PlayAnimMontage(CharacterReloadMontage);
-		PlayAnimMontage(WeaponReloadMontage);
+		float MontageDuration = CharacterOwner->PlayAnimMontage(ReloadMontage);
+		PlayAnimMontage(GCAssetStreaming::GetOrLoadAsset(WeaponReloadMontage));
 		GetWorld()->GetTimerManager().SetTimer(ReloadTimer, [this]() { EndReload(true); }, MontageDuration, false);
 	}
 	else
@@ -76,8 +79,15 @@ void ARangeWeaponItem::EndReload(bool bIsSuccess)
 	{
 		checkf(GetOwner()->IsA<AGCBaseCharacter>(), TEXT("ARangeWeaponItem::EndReload() only character can be an owner of range weapon"));
 		AGCBaseCharacter* CharacterOwner = StaticCast<AGCBaseCharacter*>(GetOwner());
-		CharacterOwner->StopAnimMontage(CharacterReloadMontage);
-		StopAnimMontage(WeaponReloadMontage);
+		// Montages that aren't loaded aren't playing either, a null montage would stop any of them
+		if (CharacterReloadMontage.IsValid())
+		{
+			CharacterOwner->StopAnimMontage(CharacterReloadMontage.Get());
+		}
+		if (WeaponReloadMontage.IsValid())
+		{
+			StopAnimMontage(WeaponReloadMontage.Get());
+		}
 	}
 	GetWorld()->GetTimerManager().ClearTimer(ReloadTimer);
 
@@ -88,9 +98,14 @@ void ARangeWeaponItem::EndReload(bool bIsSuccess)
 	}
 }
 
-FTransform ARangeWeaponItem::GetForGripTransform() const
+FTransform ARangeWeaponItem::GetForeGripRelativeTransform() const
 {
-	return WeaponMesh->GetSocketTransform(SocketWeaponForeGrip);
+	return WeaponMesh->GetSocketTransform(SocketWeaponForeGrip, RTS_Component);
+}
+
+const FTransform& ARangeWeaponItem::GetWeaponMeshTransform() const
+{
+	return WeaponMesh->GetComponentTransform();
 }
 
 int32 ARangeWeaponItem::GetAmmo() const
@@ -157,6 +172,47 @@ bool ARangeWeaponItem::IsReloading() const
 	return bIsReloading;
 }
 
+void ARangeWeaponItem::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	Super::GetStreamedAssets(OutAssets);
+	for (const TSoftObjectPtr<UAnimMontage>& Montage : { WeaponFireMontage, WeaponReloadMontage, CharacterFireMontage, CharacterReloadMontage })
+	{
+		if (!Montage.IsNull())
+		{
+			OutAssets.Add(Montage.ToSoftObjectPath());
+		}
+	}
+	WeaponBarell->GetStreamedAssets(OutAssets);
+}
+
+void ARangeWeaponItem::OnTakenFromPool(AActor* NewOwner)
+{
+	Super::OnTakenFromPool(NewOwner);
+	WeaponMesh->SetComponentTickEnabled(true);
+}
+
+void ARangeWeaponItem::OnReturnedToPool()
+{
+	GetWorld()->GetTimerManager().ClearTimer(ShotTimer);
+	GetWorld()->GetTimerManager().ClearTimer(ReloadTimer);
+
+	UAnimInstance* WeaponAnimInstance = WeaponMesh->GetAnimInstance();
+	if (IsValid(WeaponAnimInstance))
+	{
+		WeaponAnimInstance->StopAllMontages(0.f);
+	}
+	WeaponMesh->SetComponentTickEnabled(false);
+
+	OnAmmoChanged.Clear();
+	OnReloadComplete.Clear();
+	bIsAiming = false;
+	bIsFiring = false;
+	bIsReloading = false;
+	Ammo = MaxAmmo;
+
+	Super::OnReturnedToPool();
+}
+
 float ARangeWeaponItem::GetShotTimerInterval() const
 {
 	return 60.f / RateOfFire;
@@ -205,8 +261,8 @@ void ARangeWeaponItem::MakeShot()
 
 	EndReload(false);
 
-	CharacterOwner->PlayAnimMontage(CharacterFireMontage);
-	PlayAnimMontage(WeaponFireMontage);
+	CharacterOwner->PlayAnimMontage(GCAssetStreaming::GetOrLoadAsset(CharacterFireMontage));
+	PlayAnimMontage(GCAssetStreaming::GetOrLoadAsset(WeaponFireMontage));
 	
 	FVector ShotLocation;
 	FRotator ShotRotation;
@@ -34,7 +34,9 @@ public:
 	void StartReload();
 	void EndReload(bool bIsSuccess);
 
-	FTransform GetForGripTransform() const;
+	// Fore grip in the space of the weapon mesh, it only depends on the mesh so it can be cached while the weapon is equipped
+	FTransform GetForeGripRelativeTransform() const;
+	const FTransform& GetWeaponMeshTransform() const;
 
 	int32 GetAmmo() const;
 	int32 GetMaxAmmo() const;
@@ -53,6 +55,11 @@ public:
 
 	bool IsFiring() const;
 	bool IsReloading() const;
+
+	virtual void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const override;
+
+	virtual void OnTakenFromPool(AActor* NewOwner) override;
+	virtual void OnReturnedToPool() override;
 protected:
 	virtual void BeginPlay() override;
 
@@ -63,16 +70,16 @@ protected:
 	class UWeaponBarellComponent* WeaponBarell;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Animations | Weapon")
-	UAnimMontage* WeaponFireMontage;
+	TSoftObjectPtr<UAnimMontage> WeaponFireMontage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Animations | Weapon")
-	UAnimMontage* WeaponReloadMontage;
+	TSoftObjectPtr<UAnimMontage> WeaponReloadMontage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Animations | Character")
-	UAnimMontage* CharacterFireMontage;
+	TSoftObjectPtr<UAnimMontage> CharacterFireMontage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Animations | Character")
-	UAnimMontage* CharacterReloadMontage;
+	TSoftObjectPtr<UAnimMontage> CharacterReloadMontage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon | Parameters", meta = (ClampMin = 1.f, UIMin = 1.f))
 	EWeaponFireMode WeaponFireMode = EWeaponFireMode::Single;
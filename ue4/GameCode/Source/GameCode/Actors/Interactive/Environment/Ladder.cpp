@@ -24,19 +24,12 @@ ALadder::ALadder()
 	InteractionVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("InteractionVolume"));
 	InteractionVolume->SetupAttachment(RootComponent);
 	InteractionVolume->SetCollisionProfileName(CollisionProfilePawnInteractionVolume);
-	InteractionVolume->SetGenerateOverlapEvents(true);
+	InteractionVolume->SetGenerateOverlapEvents(false);
 
 	TopInteractionVolume = CreateDefaultSubobject<UBoxComponent>(TEXT("TopInteractionVolume"));
 	TopInteractionVolume->SetupAttachment(RootComponent);
 	TopInteractionVolume->SetCollisionProfileName(CollisionProfilePawnInteractionVolume);
-	TopInteractionVolume->SetGenerateOverlapEvents(true);
-}
-
-void ALadder::BeginPlay()
-{
-	Super::BeginPlay();
-	TopInteractionVolume->OnComponentBeginOverlap.AddDynamic(this, &ALadder::OnInteractionVolumeOverlapBegin);
-	TopInteractionVolume->OnComponentEndOverlap.AddDynamic(this, &ALadder::OnInteractionVolumeOverlapEnd);
+	TopInteractionVolume->SetGenerateOverlapEvents(false);
 }
 
 void ALadder::OnConstruction(const FTransform& Transform)
@@ -97,9 +90,19 @@ float ALadder::GetLadderHeight() const
 	return LadderHeight;
 }
 
-bool ALadder::GetIsOnTop() const
+bool ALadder::GetIsOnTop(const FInteractionReach& Reach) const
 {
-	return bIsOnTop;
+	return IsInVolume(TopInteractionVolume, Reach);
+}
+
+FBox ALadder::GetInteractionBounds() const
+{
+	return Super::GetInteractionBounds() + TopInteractionVolume->Bounds.GetBox();
+}
+
+bool ALadder::IsInReach(const FInteractionReach& Reach) const
+{
+	return Super::IsInReach(Reach) || IsInVolume(TopInteractionVolume, Reach);
 }
 
 class UAnimMontage* ALadder::GetAttachFromTopAnimMontage() const
@@ -120,31 +123,3 @@ class UBoxComponent* ALadder::GetLadderInteractionBox() const
 {
 	return StaticCast<UBoxComponent*>(InteractionVolume);
 }
-
-void ALadder::OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	Super::OnInteractionVolumeOverlapBegin(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
-	{
-		return;
-	}
-
-	if (OverlappedComponent == TopInteractionVolume)
-	{
-		bIsOnTop = true;
-	}
-}
-
-void ALadder::OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
-{
-	Super::OnInteractionVolumeOverlapEnd(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex);
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
-	{
-		return;
-	}
-
-	if (OverlappedComponent == TopInteractionVolume)
-	{
-		bIsOnTop = false;
-	}
-}
@@ -20,13 +20,15 @@ class GAMECODE_API ALadder : public AInteractiveActor
 public:
 	ALadder();
 
-	virtual void BeginPlay() override;
-
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 	float GetLadderHeight() const;
 
-	bool GetIsOnTop() const;
+	bool GetIsOnTop(const FInteractionReach& Reach) const;
+
+	virtual FBox GetInteractionBounds() const override;
+
+	virtual bool IsInReach(const FInteractionReach& Reach) const override;
 
 	UAnimMontage* GetAttachFromTopAnimMontage() const;
 
@@ -68,10 +70,4 @@ protected:
 	FVector AttachFromTopAnimMontageInitialOffset = FVector::ZeroVector;
 
 	UBoxComponent* GetLadderInteractionBox() const;
-
-	virtual void OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult) override;
-	virtual void OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex) override;
-
-private:
-	bool bIsOnTop = false;
 };
@@ -24,7 +24,7 @@ AZipline::AZipline()
 	InteractionVolume = CreateDefaultSubobject<UCapsuleComponent>(TEXT("InteractionVolume"));
 	InteractionVolume->SetupAttachment(RootComponent);
 	InteractionVolume->SetCollisionProfileName(CollisionProfilePawnInteractionVolume);
-	InteractionVolume->SetGenerateOverlapEvents(true);
+	InteractionVolume->SetGenerateOverlapEvents(false);
 }
 
 void AZipline::OnConstruction(const FTransform& Transform)
@@ -105,6 +105,15 @@ FVector AZipline::GetZiplineVector() const
 	return Result;
 }
 
+FVector AZipline::GetZiplineEndPoint() const
+{
+	FVector FirstPoleTop = GetActorTransform().TransformPosition(FirstPoleLocation + PolesHeight * 0.5f * FVector::UpVector);
+	FVector SecondPoleTop = GetActorTransform().TransformPosition(SecondPoleLocation + PolesHeight * 0.5f * FVector::UpVector);
+
+	FVector ZiplineVector = GetZiplineVector();
+	return FVector::DotProduct(FirstPoleTop, ZiplineVector) > FVector::DotProduct(SecondPoleTop, ZiplineVector) ? FirstPoleTop : SecondPoleTop;
+}
+
 class UCapsuleComponent* AZipline::GetZiplineInteractionCapsule() const
 {
 	return StaticCast<UCapsuleComponent*>(InteractionVolume);
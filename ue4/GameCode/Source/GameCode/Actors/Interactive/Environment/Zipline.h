@@ -26,6 +26,8 @@ public:
 
 	FVector GetZiplineVector() const;
 
+	FVector GetZiplineEndPoint() const;
+
 protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	UStaticMeshComponent* FirstPoleStaticMeshComponent;
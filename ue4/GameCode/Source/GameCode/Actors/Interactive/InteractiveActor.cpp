@@ -2,54 +2,76 @@
 
 
 #include "InteractiveActor.h"
-#include "../../Characters/GCBaseCharacter.h"
+#include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Misc/Crc.h"
+#include "Subsystems/InteractiveActorsSubsystem.h"
+
+FInteractionReach::FInteractionReach(const ACharacter* Character)
+{
+	const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	Location = Character->GetActorLocation();
+	Radius = Capsule->GetScaledCapsuleRadius();
+	HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+}
+
+FBox AInteractiveActor::GetInteractionBounds() const
+{
+	return IsValid(InteractionVolume) ? InteractionVolume->Bounds.GetBox() : FBox(ForceInit);
+}
+
+bool AInteractiveActor::IsInReach(const FInteractionReach& Reach) const
+{
+	return IsValid(InteractionVolume) && IsInVolume(InteractionVolume, Reach);
+}
 
 void AInteractiveActor::BeginPlay()
 {
 	Super::BeginPlay();
+	// Name table indices differ between processes, the level package and the level relative path don't
+	FString StablePath = UWorld::RemovePIEPrefix(GetOutermost()->GetName()) + TEXT(":") + GetPathName(GetLevel());
+	InteractiveActorId = FMath::Max(FCrc::StrCrc32(*StablePath), 1u);
 	if (IsValid(InteractionVolume))
 	{
-		InteractionVolume->OnComponentBeginOverlap.AddDynamic(this, &AInteractiveActor::OnInteractionVolumeOverlapBegin);
-		InteractionVolume->OnComponentEndOverlap.AddDynamic(this, &AInteractiveActor::OnInteractionVolumeOverlapEnd);
+		GetWorld()->GetSubsystem<UInteractiveActorsSubsystem>()->RegisterInteractiveActor(this);
 	}
 }
 
-void AInteractiveActor::OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AInteractiveActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
+	if (IsValid(InteractionVolume))
 	{
-		return;
+		GetWorld()->GetSubsystem<UInteractiveActorsSubsystem>()->UnregisterInteractiveActor(this);
 	}
-
-	AGCBaseCharacter* BaseCharacter = StaticCast<AGCBaseCharacter*>(OtherActor);
-
-	BaseCharacter->RegisterInteractiveActor(this);
+	Super::EndPlay(EndPlayReason);
 }
 
-void AInteractiveActor::OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+bool AInteractiveActor::IsInVolume(const UPrimitiveComponent* Volume, const FInteractionReach& Reach)
 {
-	if (!IsOverlappingCharacterCapsule(OtherActor, OtherComp))
+	const UBoxComponent* Box = Cast<UBoxComponent>(Volume);
+	if (IsValid(Box))
 	{
-		return;
+		FVector LocalLocation = Box->GetComponentTransform().InverseTransformPositionNoScale(Reach.Location);
+		FVector BoxExtent = Box->GetScaledBoxExtent();
+		return FMath::Abs(LocalLocation.X) <= BoxExtent.X + Reach.Radius
+			&& FMath::Abs(LocalLocation.Y) <= BoxExtent.Y + Reach.Radius
+			&& FMath::Abs(LocalLocation.Z) <= BoxExtent.Z + Reach.HalfHeight;
 	}
 
-	AGCBaseCharacter* BaseCharacter = StaticCast<AGCBaseCharacter*>(OtherActor);
-
-	BaseCharacter->UnregisterInteractiveActor(this);
-}
-
-bool AInteractiveActor::IsOverlappingCharacterCapsule(AActor* OtherActor, UPrimitiveComponent* OtherComp)
-{
-	AGCBaseCharacter* BaseCharacter = Cast<AGCBaseCharacter>(OtherActor);
-	if (!IsValid(BaseCharacter))
+	const UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(Volume);
+	if (IsValid(Capsule))
 	{
-		return false;
-	}
+		FVector VolumeCenter = Capsule->GetComponentLocation();
+		FVector VolumeAxis = Capsule->GetUpVector() * Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+		FVector ReachAxis = FVector::UpVector * FMath::Max(0.0f, Reach.HalfHeight - Reach.Radius);
 
-	if (Cast<UCapsuleComponent>(OtherComp) != BaseCharacter->GetCapsuleComponent())
-	{
-		return false;
+		FVector VolumePoint;
+		FVector ReachPoint;
+		FMath::SegmentDistToSegmentSafe(VolumeCenter - VolumeAxis, VolumeCenter + VolumeAxis, Reach.Location - ReachAxis, Reach.Location + ReachAxis, VolumePoint, ReachPoint);
+		return FVector::DistSquared(VolumePoint, ReachPoint) <= FMath::Square(Capsule->GetScaledCapsuleRadius() + Reach.Radius);
 	}
-	return true;
+
+	return Volume->Bounds.GetBox().ExpandBy(FVector(Reach.Radius, Reach.Radius, Reach.HalfHeight)).IsInsideOrOn(Reach.Location);
 }
@@ -6,26 +6,42 @@
 #include "GameFramework/Actor.h"
 #include "InteractiveActor.generated.h"
 
+struct FInteractionReach
+{
+	FInteractionReach(const FVector& InLocation, float InRadius, float InHalfHeight)
+		: Location(InLocation), Radius(InRadius), HalfHeight(InHalfHeight) {}
+
+	explicit FInteractionReach(const ACharacter* Character);
+
+	FVector Location = FVector::ZeroVector;
+	float Radius = 0.0f;
+	float HalfHeight = 0.0f;
+};
+
 UCLASS(Abstract, NotBlueprintable)
 class GAMECODE_API AInteractiveActor : public AActor
 {
 	GENERATED_BODY()
 	
 public:	
+	virtual FBox GetInteractionBounds() const;
+
+	virtual bool IsInReach(const FInteractionReach& Reach) const;
 
+	// Compact id stable between server and clients for placed actors, never 0
+	uint32 GetInteractiveActorId() const { return InteractiveActorId; }
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Interaction")
 	UPrimitiveComponent* InteractionVolume;
 
-	UFUNCTION()
-	virtual void OnInteractionVolumeOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	UFUNCTION()
-	virtual void OnInteractionVolumeOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+	static bool IsInVolume(const UPrimitiveComponent* Volume, const FInteractionReach& Reach);
 
-	bool IsOverlappingCharacterCapsule(AActor* OtherActor, UPrimitiveComponent* OtherComp);
+private:
+	uint32 InteractiveActorId = 0;
 };
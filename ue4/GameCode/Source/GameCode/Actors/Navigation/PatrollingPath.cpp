@@ -2,9 +2,120 @@
 
 
 #include "PatrollingPath.h"
+#include "Algo/Sort.h"
 
+void FWayPointKdTree::Build(const TArray<FVector>& Points)
+{
+	Nodes.SetNumUninitialized(Points.Num());
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		Nodes[i] = i;
+	}
+	Build(Points, 0, Nodes.Num(), 0);
+}
+
+int32 FWayPointKdTree::FindClosest(const TArray<FVector>& Points, const FVector& Location) const
+{
+	int32 Closest = INDEX_NONE;
+	float MinDistanceSquared = FLT_MAX;
+	FindClosest(Points, Location, 0, Nodes.Num(), 0, Closest, MinDistanceSquared);
+	return Closest;
+}
+
+void FWayPointKdTree::Build(const TArray<FVector>& Points, int32 Begin, int32 End, int32 Axis)
+{
+	if (End - Begin <= 1)
+	{
+		return;
+	}
+
+	// Paths are short and baked rarely, sorting the range is enough to find the median
+	TArrayView<int32> Range(Nodes.GetData() + Begin, End - Begin);
+	Algo::Sort(Range, [&Points, Axis](int32 A, int32 B) { return Points[A][Axis] < Points[B][Axis]; });
+
+	int32 Median = Begin + (End - Begin) / 2;
+	Build(Points, Begin, Median, (Axis + 1) % 3);
+	Build(Points, Median + 1, End, (Axis + 1) % 3);
+}
+
+void FWayPointKdTree::FindClosest(const TArray<FVector>& Points, const FVector& Location, int32 Begin, int32 End, int32 Axis, int32& InOutClosest, float& InOutMinDistanceSquared) const
+{
+	if (Begin >= End)
+	{
+		return;
+	}
+
+	int32 Median = Begin + (End - Begin) / 2;
+	const FVector& Point = Points[Nodes[Median]];
+	float DistanceSquared = FVector::DistSquared(Point, Location);
+	if (DistanceSquared < InOutMinDistanceSquared)
+	{
+		InOutMinDistanceSquared = DistanceSquared;
+		InOutClosest = Nodes[Median];
+	}
+
+	float AxisDistance = Location[Axis] - Point[Axis];
+	int32 NextAxis = (Axis + 1) % 3;
+	if (AxisDistance < 0.0f)
+	{
+		FindClosest(Points, Location, Begin, Median, NextAxis, InOutClosest, InOutMinDistanceSquared);
+		if (FMath::Square(AxisDistance) < InOutMinDistanceSquared)
+		{
+			FindClosest(Points, Location, Median + 1, End, NextAxis, InOutClosest, InOutMinDistanceSquared);
+		}
+	}
+	else
+	{
+		FindClosest(Points, Location, Median + 1, End, NextAxis, InOutClosest, InOutMinDistanceSquared);
+		if (FMath::Square(AxisDistance) < InOutMinDistanceSquared)
+		{
+			FindClosest(Points, Location, Begin, Median, NextAxis, InOutClosest, InOutMinDistanceSquared);
+		}
+	}
+}
+
+void APatrollingPath::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	if (IsValid(RootComponent))
+	{
+		RootComponent->TransformUpdated.AddUObject(this, &APatrollingPath::OnRootTransformUpdated);
+	}
+	bIsBakeDirty = true;
+}
 
 const TArray<FVector>& APatrollingPath::GetWayPoints() const
 {
 	return WayPoints;
 }
+
+const TArray<FVector>& APatrollingPath::GetWorldWayPoints() const
+{
+	if (bIsBakeDirty)
+	{
+		BakeWayPoints();
+	}
+	return WorldWayPoints;
+}
+
+int32 APatrollingPath::FindClosestWayPoint(const FVector& Location) const
+{
+	return WayPointsTree.FindClosest(GetWorldWayPoints(), Location);
+}
+
+void APatrollingPath::OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	bIsBakeDirty = true;
+}
+
+void APatrollingPath::BakeWayPoints() const
+{
+	FTransform PathTransform = GetActorTransform();
+	WorldWayPoints.SetNumUninitialized(WayPoints.Num());
+	for (int32 i = 0; i < WayPoints.Num(); ++i)
+	{
+		WorldWayPoints[i] = PathTransform.TransformPosition(WayPoints[i]);
+	}
+	WayPointsTree.Build(WorldWayPoints);
+	bIsBakeDirty = false;
+}
@@ -6,15 +6,45 @@
 #include "GameFramework/Actor.h"
 #include "PatrollingPath.generated.h"
 
+/**
+ * Balanced k-d tree over a point array, stored implicitly: the median of a range is its node, halves are its children
+ */
+struct FWayPointKdTree
+{
+	void Build(const TArray<FVector>& Points);
+	int32 FindClosest(const TArray<FVector>& Points, const FVector& Location) const;
+
+private:
+	void Build(const TArray<FVector>& Points, int32 Begin, int32 End, int32 Axis);
+	void FindClosest(const TArray<FVector>& Points, const FVector& Location, int32 Begin, int32 End, int32 Axis, int32& InOutClosest, float& InOutMinDistanceSquared) const;
+
+	// Point indices in tree order
+	TArray<int32> Nodes;
+};
+
 UCLASS()
 class GAMECODE_API APatrollingPath : public AActor
 {
 	GENERATED_BODY()
 public:
+	virtual void PostInitializeComponents() override;
+
 	const TArray<FVector>& GetWayPoints() const;
+
+	// Way points in world space, baked again only after the path has moved
+	const TArray<FVector>& GetWorldWayPoints() const;
+
+	int32 FindClosestWayPoint(const FVector& Location) const;
 	
 protected:
 	UPROPERTY(EditInstanceOnly, BlueprintReadOnly, Category = "Path", meta = (MakeEditWidget))
 	TArray<FVector> WayPoints;
 
+private:
+	void OnRootTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+	void BakeWayPoints() const;
+
+	mutable TArray<FVector> WorldWayPoints;
+	mutable FWayPointKdTree WayPointsTree;
+	mutable bool bIsBakeDirty = true;
 };
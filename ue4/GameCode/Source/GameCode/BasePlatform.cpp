@@ -4,6 +4,7 @@
 #include "Components/SceneComponent.h"
 #include "PlatformInvocator.h"
 #include "Math/UnrealMathVectorCommon.h"
+#include "Subsystems/TickSignificanceSubsystem.h"
 
 ABasePlatform::ABasePlatform()
 {
@@ -33,6 +34,13 @@ void ABasePlatform::BeginPlay()
 		PlatformTimelineFinishedCallback.BindUObject(this, &ABasePlatform::OnTimelineFinished);
 		PlatformTimeline.SetTimelineFinishedFunc(PlatformTimelineFinishedCallback);
 	}
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->RegisterActor(this);
+}
+
+void ABasePlatform::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->UnregisterActor(this);
+	Super::EndPlay(EndPlayReason);
 }
 
 void ABasePlatform::Tick(const float DeltaTime)
@@ -59,6 +59,7 @@ protected:
 	bool bIsLoopPlatformTimerOn = false;
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 
 private:
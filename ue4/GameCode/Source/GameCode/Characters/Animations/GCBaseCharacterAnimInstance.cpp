@@ -7,58 +7,143 @@
 #include <Components/CharacterComponents/CharacterEquipmentComponent.h>
 #include <Actors/Equipment/Weapons/RangeWeaponItem.h>
 
-void UGCBaseCharacterAnimInstance::NativeBeginPlay()
+DECLARE_CYCLE_STAT(TEXT("Character anim state gather"), STAT_CharacterAnimStateGather, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Character anim state update"), STAT_CharacterAnimStateUpdate, STATGROUP_GameCode);
+
+void FGCBaseCharacterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	Super::NativeBeginPlay();
-	checkf(TryGetPawnOwner()->IsA<AGCBaseCharacter>(), TEXT("void UGCBaseCharacterAnimInstance::NativeBeginPlay() can be used only with AGCBaseCharacter"));
-	CachedBaseCharacter = StaticCast<AGCBaseCharacter*>(TryGetPawnOwner());
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
+	SCOPE_CYCLE_COUNTER(STAT_CharacterAnimStateGather);
+
+	UGCBaseCharacterAnimInstance* AnimInstance = StaticCast<UGCBaseCharacterAnimInstance*>(InAnimInstance);
+	AGCBaseCharacter* Character = AnimInstance->CachedBaseCharacter.Get();
+	bIsStateValid = IsValid(Character);
+	if (!bIsStateValid)
+	{
+		return;
+	}
+
+	const UGCBaseCharacterMovementComponent* CharacterMovement = Character->GetBaseCharacterMovementComponent();
+	State.Velocity = CharacterMovement->Velocity;
+	State.ActorRotation = Character->GetActorRotation();
+	State.AimRotation = Character->GetBaseAimRotation();
+
+	State.bIsFalling = CharacterMovement->IsFalling();
+	State.bIsCrouching = CharacterMovement->IsCrouching();
+	State.bIsSprinting = CharacterMovement->IsSprinting();
+	State.bIsSliding = CharacterMovement->IsSliding();
+	State.bIsOutOfStamina = CharacterMovement->IsOutOfStamina();
+	State.bIsSwimming = CharacterMovement->IsSwimming();
+	State.bIsOnLadder = CharacterMovement->IsOnLadder();
+	State.bIsOnZipline = CharacterMovement->IsOnZipline();
+	State.bIsWallRunning = CharacterMovement->IsWallRunning();
+	State.bIsStrafing = !CharacterMovement->bOrientRotationToMovement;
+	State.bIsAiming = Character->IsAiming();
+
+	if (State.bIsOnLadder)
+	{
+		State.LadderSpeedRatio = CharacterMovement->GetLadderSpeedRatio();
+	}
+	if (State.bIsWallRunning)
+	{
+		State.WallRunSide = CharacterMovement->GetWallRunParameters().Side;
+	}
+
+	State.IKRightFootOffset = Character->GetIKRightFootOffset();
+	State.IKLeftFootOffset = Character->GetIKLeftFootOffset();
+	State.IKPelvisOffset = Character->GetIKPelvisOffset();
+
+	State.EquippedItemType = Character->GetCharacterEquipmentComponent()->GetCurrentEquippedItemType();
+	ARangeWeaponItem* CurrentRangeWeapon = AnimInstance->CachedRangeWeapon.Get();
+	State.bHasRangeWeapon = IsValid(CurrentRangeWeapon);
+	if (State.bHasRangeWeapon)
+	{
+		State.WeaponMeshTransform = CurrentRangeWeapon->GetWeaponMeshTransform();
+		// Equip changes it on the game thread, the worker only sees the copy
+		State.ForeGripRelativeTransform = AnimInstance->CachedForeGripRelativeTransform;
+	}
 }
 
-void UGCBaseCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+void FGCBaseCharacterAnimInstanceProxy::Update(float DeltaSeconds)
 {
-	Super::NativeUpdateAnimation(DeltaSeconds);
-	if (!CachedBaseCharacter.IsValid())
+	Super::Update(DeltaSeconds);
+	if (!bIsStateValid)
 	{
 		return;
 	}
+	SCOPE_CYCLE_COUNTER(STAT_CharacterAnimStateUpdate);
+
+	// The game thread doesn't touch the anim instance until the parallel update is over
+	UGCBaseCharacterAnimInstance* AnimInstance = StaticCast<UGCBaseCharacterAnimInstance*>(GetAnimInstanceObject());
+	AnimInstance->Speed = State.Velocity.Size();
+	AnimInstance->bIsFalling = State.bIsFalling;
+	AnimInstance->bIsCrouching = State.bIsCrouching;
+	AnimInstance->bIsSprinting = State.bIsSprinting;
+	AnimInstance->bIsSliding = State.bIsSliding;
+	AnimInstance->bIsOutOfStamina = State.bIsOutOfStamina;
+	AnimInstance->bIsSwimming = State.bIsSwimming;
+	AnimInstance->bIsOnLadder = State.bIsOnLadder;
+	AnimInstance->bIsOnZipline = State.bIsOnZipline;
+	AnimInstance->bIsWallRunning = State.bIsWallRunning;
+	AnimInstance->bIsAiming = State.bIsAiming;
 
-	UGCBaseCharacterMovementComponent* CharacterMovement = CachedBaseCharacter->GetBaseCharacterMovementComponent();
-	Speed = CharacterMovement->Velocity.Size();
-	bIsFalling = CharacterMovement->IsFalling();
-	bIsCrouching = CharacterMovement->IsCrouching();
-	bIsSprinting = CharacterMovement->IsSprinting();
-	bIsSliding = CharacterMovement->IsSliding();
-	bIsOutOfStamina = CharacterMovement->IsOutOfStamina();
-	bIsSwimming = CharacterMovement->IsSwimming();
-	bIsOnLadder = CharacterMovement->IsOnLadder();
-	bIsOnZipline = CharacterMovement->IsOnZipline();
-	bIsWallRunning = CharacterMovement->IsWallRunning();
-	bIsAiming = CachedBaseCharacter->IsAiming();
-
-	if (bIsOnLadder)
+	if (State.bIsOnLadder)
 	{
-		LadderSpeedRatio = CharacterMovement->GetLadderSpeedRatio();
+		AnimInstance->LadderSpeedRatio = State.LadderSpeedRatio;
 	}
-	if (bIsWallRunning)
+	if (State.bIsWallRunning)
 	{
-		WallRunSide = CharacterMovement->GetWallRunParameters().Side;
+		AnimInstance->WallRunSide = State.WallRunSide;
 	}
 
-	bIsStrafing = !CharacterMovement->bOrientRotationToMovement;
-	Direction = CalculateDirection(CharacterMovement->Velocity, CachedBaseCharacter->GetActorRotation());
+	AnimInstance->bIsStrafing = State.bIsStrafing;
+	AnimInstance->Direction = AnimInstance->CalculateDirection(State.Velocity, State.ActorRotation);
 
-	IKRightFootOffset = FVector(CachedBaseCharacter->GetIKRightFootOffset() + CachedBaseCharacter->GetIKPelvisOffset(), 0.0f, 0.0f);
-	IKLeftFootOffset = FVector(-(CachedBaseCharacter->GetIKLeftFootOffset() + CachedBaseCharacter->GetIKPelvisOffset()), 0.0f, 0.0f);
-	IKPelvisOffset = FVector(0.0f, 0.0f, CachedBaseCharacter->GetIKPelvisOffset());
+	AnimInstance->IKRightFootOffset = FVector(State.IKRightFootOffset + State.IKPelvisOffset, 0.0f, 0.0f);
+	AnimInstance->IKLeftFootOffset = FVector(-(State.IKLeftFootOffset + State.IKPelvisOffset), 0.0f, 0.0f);
+	AnimInstance->IKPelvisOffset = FVector(0.0f, 0.0f, State.IKPelvisOffset);
 
-	AimRotation = CachedBaseCharacter->GetBaseAimRotation();
+	AnimInstance->AimRotation = State.AimRotation;
+	AnimInstance->CurrentEquippedItemType = State.EquippedItemType;
 
-	const UCharacterEquipmentComponent* CharacterEquipment = CachedBaseCharacter->GetCharacterEquipmentComponent();
-	CurrentEquippedItemType = CharacterEquipment->GetCurrentEquippedItemType();
+	if (State.bHasRangeWeapon)
+	{
+		AnimInstance->ForeGripSocketTransform = State.ForeGripRelativeTransform * State.WeaponMeshTransform;
+	}
+}
+
+void UGCBaseCharacterAnimInstance::NativeBeginPlay()
+{
+	Super::NativeBeginPlay();
+	checkf(TryGetPawnOwner()->IsA<AGCBaseCharacter>(), TEXT("void UGCBaseCharacterAnimInstance::NativeBeginPlay() can be used only with AGCBaseCharacter"));
+	CachedBaseCharacter = StaticCast<AGCBaseCharacter*>(TryGetPawnOwner());
+
+	UCharacterEquipmentComponent* CharacterEquipment = CachedBaseCharacter->GetCharacterEquipmentComponent_Mutable();
+	CurrentWeaponChangedHandle = CharacterEquipment->OnCurrentWeaponChangedEvent.AddUObject(this, &UGCBaseCharacterAnimInstance::OnCurrentWeaponChanged);
+	OnCurrentWeaponChanged(CharacterEquipment->GetCurrentRangeWeapon());
+}
 
-	ARangeWeaponItem* CurrentRangeWeapon = CharacterEquipment->GetCurrentRangeWeapon();
-	if (IsValid(CurrentRangeWeapon))
+void UGCBaseCharacterAnimInstance::NativeUninitializeAnimation()
+{
+	if (CachedBaseCharacter.IsValid())
 	{
-		ForeGripSocketTransform = CurrentRangeWeapon->GetForGripTransform();
+		CachedBaseCharacter->GetCharacterEquipmentComponent_Mutable()->OnCurrentWeaponChangedEvent.Remove(CurrentWeaponChangedHandle);
 	}
+	Super::NativeUninitializeAnimation();
+}
+
+FAnimInstanceProxy* UGCBaseCharacterAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FGCBaseCharacterAnimInstanceProxy(this);
+}
+
+void UGCBaseCharacterAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	delete StaticCast<FGCBaseCharacterAnimInstanceProxy*>(InProxy);
+}
+
+void UGCBaseCharacterAnimInstance::OnCurrentWeaponChanged(ARangeWeaponItem* NewWeapon)
+{
+	CachedRangeWeapon = NewWeapon;
+	CachedForeGripRelativeTransform = IsValid(NewWeapon) ? NewWeapon->GetForeGripRelativeTransform() : FTransform::Identity;
 }
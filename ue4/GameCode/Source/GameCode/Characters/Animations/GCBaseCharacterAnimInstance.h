@@ -4,10 +4,64 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "../../Components/GCBaseCharacterMovementComponent.h"
 #include <GameCodeTypes.h>
 #include "GCBaseCharacterAnimInstance.generated.h"
 
+// Everything the animation update needs from the character, copied once per frame on the game thread
+struct FGCBaseCharacterAnimState
+{
+	FVector Velocity = FVector::ZeroVector;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FTransform WeaponMeshTransform;
+	FTransform ForeGripRelativeTransform;
+
+	float LadderSpeedRatio = 0.0f;
+	float IKRightFootOffset = 0.0f;
+	float IKLeftFootOffset = 0.0f;
+	float IKPelvisOffset = 0.0f;
+
+	EWallRunSide WallRunSide = EWallRunSide::None;
+	EEquipableItemType EquippedItemType = EEquipableItemType::None;
+
+	bool bIsFalling = false;
+	bool bIsCrouching = false;
+	bool bIsSprinting = false;
+	bool bIsSliding = false;
+	bool bIsOutOfStamina = false;
+	bool bIsSwimming = false;
+	bool bIsOnLadder = false;
+	bool bIsOnZipline = false;
+	bool bIsWallRunning = false;
+	bool bIsAiming = false;
+	bool bIsStrafing = false;
+	bool bHasRangeWeapon = false;
+};
+
+/**
+ * Gathers the character state in PreUpdate on the game thread and turns it into anim instance variables in Update,
+ * which runs on a worker thread together with the graph update
+ */
+USTRUCT()
+struct GAMECODE_API FGCBaseCharacterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+public:
+	FGCBaseCharacterAnimInstanceProxy() = default;
+	FGCBaseCharacterAnimInstanceProxy(UAnimInstance* Instance) : FAnimInstanceProxy(Instance) {}
+
+protected:
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	FGCBaseCharacterAnimState State;
+	bool bIsStateValid = false;
+};
+
 /**
  * 
  */
@@ -15,12 +69,17 @@ UCLASS()
 class GAMECODE_API UGCBaseCharacterAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
+
+	friend struct FGCBaseCharacterAnimInstanceProxy;
 	
 public:
 	virtual void NativeBeginPlay() override;
-	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+	virtual void NativeUninitializeAnimation() override;
 
 protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character animation")
 	float Speed = 0.0f;
 
@@ -85,5 +144,12 @@ protected:
 	FTransform ForeGripSocketTransform;
 	
 private:
+	void OnCurrentWeaponChanged(class ARangeWeaponItem* NewWeapon);
+
 	TWeakObjectPtr<class AGCBaseCharacter> CachedBaseCharacter;
+
+	// Socket lookups are only done on equip, every frame just moves the cached transform with the weapon mesh
+	FTransform CachedForeGripRelativeTransform;
+	TWeakObjectPtr<class ARangeWeaponItem> CachedRangeWeapon;
+	FDelegateHandle CurrentWeaponChangedHandle;
 };
\ No newline at end of file
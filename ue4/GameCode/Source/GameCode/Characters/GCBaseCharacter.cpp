@@ -7,7 +7,6 @@
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
-#include "Kismet/KismetSystemLibrary.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Components/LedgeDetectorComponent.h"
 #include "Actors/Interactive/Environment/Ladder.h"
@@ -16,6 +15,11 @@
 #include "Components/CharacterComponents/CharacterAttributesComponent.h"
 #include <GameFramework/PhysicsVolume.h>
 #include "Components/CharacterComponents/CharacterEquipmentComponent.h"
+#include "Subsystems/AnimBudgetSubsystem.h"
+#include "Subsystems/CombatSnapshotSubsystem.h"
+#include "Subsystems/FootIKSubsystem.h"
+#include "Subsystems/InteractiveActorsSubsystem.h"
+#include "Subsystems/TickSignificanceSubsystem.h"
 #include <Actors/Equipment/Weapons/RangeWeaponItem.h>
 
 #include "AIController.h"
@@ -43,6 +47,26 @@ void AGCBaseCharacter::BeginPlay()
 	GetCapsuleComponent()->OnComponentHit.AddDynamic(this, &AGCBaseCharacter::OnPlayerCapsuleHit);
 	CharacterAttributesComponent->OnDeathEvent.AddUObject(this, &AGCBaseCharacter::OnDeath);
 	CharacterAttributesComponent->OutOfStaminaEvent.AddUObject(GetBaseCharacterMovementComponent(), &UGCBaseCharacterMovementComponent::SetIsOutOfStamina);
+
+	FFootIKProbeSettings FootIKSettings;
+	FootIKSettings.TraceLength = IKTraceDistance;
+	FootIKSettings.BoxExtent = FVector(1.f, 10.f, 4.f);
+	FootIKAgentId = GetWorld()->GetSubsystem<UFootIKSubsystem>()->RegisterAgent(this, GetMesh(), { RightFootSocketName, LeftFootSocketName }, FootIKSettings);
+	GetWorld()->GetSubsystem<UAnimBudgetSubsystem>()->RegisterMesh(this, GetMesh(), FootIKAgentId, FOnAnimTickRateChanged::CreateUObject(this, &AGCBaseCharacter::OnAnimTickRateChanged));
+
+	// Tick holds sprint, foot IK and slide state, a second long dormant interval would break them
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->RegisterActor(this, TArray<UActorComponent*>(), ETickSignificanceBucket::Reduced);
+	GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>()->RegisterCombatant(this);
+}
+
+void AGCBaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetSubsystem<UAnimBudgetSubsystem>()->UnregisterMesh(this);
+	GetWorld()->GetSubsystem<UFootIKSubsystem>()->UnregisterAgent(FootIKAgentId);
+	FootIKAgentId = INDEX_NONE;
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->UnregisterActor(this);
+	GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>()->UnregisterCombatant(this);
+	Super::EndPlay(EndPlayReason);
 }
 
 void AGCBaseCharacter::PossessedBy(AController* NewController)
@@ -54,6 +78,20 @@ void AGCBaseCharacter::PossessedBy(AController* NewController)
 		FGenericTeamId TeamId((uint8)Team);
 		AIController->SetGenericTeamId(TeamId);
 	}
+	LedgeDetectorComponent->OnOwnerControllerChanged();
+}
+
+void AGCBaseCharacter::UnPossessed()
+{
+	Super::UnPossessed();
+	LedgeDetectorComponent->OnOwnerControllerChanged();
+}
+
+void AGCBaseCharacter::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+	// Owning client learns about the possession here, PossessedBy runs on the server only
+	LedgeDetectorComponent->OnOwnerControllerChanged();
 }
 
 void AGCBaseCharacter::ChangeCrouchState()
@@ -104,8 +142,7 @@ void AGCBaseCharacter::StopSlide()
 		FRotator MeshRotation = CurrentSlideSettings.SlideRotation + FRotator(0.f, -90.f, 0.f);
 		
 		FVector OverlapLocation = GetActorLocation() + CurrentSlideSettings.CapsuleHeightAdjustment * FVector::UpVector;
-		FCollisionQueryParams QueryParams;
-		if (GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, DefaultCapsuleRadius, DefaultCapsuleHalfHeight, FQuat::Identity, CollisionProfileIgnorePawn, QueryParams, true, 4.f))
+		if (GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, DefaultCapsuleRadius, DefaultCapsuleHalfHeight, FQuat::Identity, CollisionProfileIgnorePawn, GetBaseCharacterMovementComponent()->GetOwnerQueryParams(), true, 4.f))
 		{
 			Crouch();
 		}
@@ -137,6 +174,19 @@ void AGCBaseCharacter::StopSprint()
 	bIsSprintRequested = false;
 }
 
+void AGCBaseCharacter::SetSprintRequestedByMove(bool bIsRequested)
+{
+	if (bIsRequested)
+	{
+		StartSprint();
+	}
+	else
+	{
+		StopSprint();
+	}
+	TryChangeSprintState();
+}
+
 void AGCBaseCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -180,6 +230,7 @@ void AGCBaseCharacter::StartAiming()
 	}
 	bIsAiming = true;
 	CurrentAimingMovementSpeed = CurrentRangeWeapon->GetAimMovementMaxSpeed();
+	GetBaseCharacterMovementComponent()->SetIsAiming(true);
 	CurrentRangeWeapon->StartAim();
 	OnStartAiming();
 }
@@ -198,6 +249,7 @@ void AGCBaseCharacter::StopAiming()
 	}
 	bIsAiming = false;
 	CurrentAimingMovementSpeed = 0.f;
+	GetBaseCharacterMovementComponent()->SetIsAiming(false);
 	OnStopAiming();
 }
 
@@ -314,21 +366,11 @@ void AGCBaseCharacter::EndHardLanding()
 	EnableMeshRotation();
 }
 
-void AGCBaseCharacter::RegisterInteractiveActor(AInteractiveActor* InteractiveActor)
-{
-	AvailableInteractiveActors.AddUnique(InteractiveActor);
-}
-
-void AGCBaseCharacter::UnregisterInteractiveActor(AInteractiveActor* InteractiveActor)
-{
-	AvailableInteractiveActors.RemoveSingleSwap(InteractiveActor);
-}
-
 void AGCBaseCharacter::ClimbLadderUp(float Value)
 {
 	if (GetBaseCharacterMovementComponent()->IsOnLadder() &&!FMath::IsNearlyZero(Value))
 	{
-		FVector LadderUpVector = GetBaseCharacterMovementComponent()->GetCurrentLadder()->GetActorUpVector();
+		FVector LadderUpVector = GetBaseCharacterMovementComponent()->GetCurrentLadderSegment().UpVector;
 		AddMovementInput(LadderUpVector, Value);
 	}
 }
@@ -348,7 +390,7 @@ void AGCBaseCharacter::InteractWithLadder()
 		const ALadder* AvailableLadder = GetAvailableLadder();
 		if (IsValid(AvailableLadder))
 		{
-			if (AvailableLadder->GetIsOnTop())
+			if (AvailableLadder->GetIsOnTop(FInteractionReach(this)))
 			{
 				PlayAnimMontage(AvailableLadder->GetAttachFromTopAnimMontage());
 			}
@@ -359,17 +401,7 @@ void AGCBaseCharacter::InteractWithLadder()
 
 const class ALadder* AGCBaseCharacter::GetAvailableLadder()
 {
-	const ALadder* Result = nullptr;
-	
-	for (const AInteractiveActor* InteractiveActor : AvailableInteractiveActors)
-	{
-		if (InteractiveActor->IsA<ALadder>())
-		{
-			Result = StaticCast<const ALadder*>(InteractiveActor);
-			break;
-		}
-	}
-	return Result;
+	return GetWorld()->GetSubsystem<UInteractiveActorsSubsystem>()->FindClosestInReach<ALadder>(FInteractionReach(this));
 }
 
 void AGCBaseCharacter::InteractWithZipline()
@@ -395,16 +427,7 @@ void AGCBaseCharacter::InteractWithZipline()
 
 const class AZipline* AGCBaseCharacter::GetAvailableZipline()
 {
-	const AZipline* Result = nullptr;
-	for (const AInteractiveActor* InteractiveActor : AvailableInteractiveActors)
-	{
-		if (InteractiveActor->IsA<AZipline>())
-		{
-			Result = StaticCast<const AZipline*>(InteractiveActor);
-			break;
-		}
-	}
-	return Result;
+	return GetWorld()->GetSubsystem<UInteractiveActorsSubsystem>()->FindClosestInReach<AZipline>(FInteractionReach(this));
 }
 
 bool AGCBaseCharacter::IsWallRunRequested() const
@@ -439,6 +462,7 @@ void AGCBaseCharacter::Landed(const FHitResult& Hit)
 	float FallHeight = (CurrentFallApex - Hit.Location).Z;
 	if (IsValid(FallDamageCurve))
 	{
+		// Applied right away instead of going through UDamageSubsystem, hard landing depends on the outcome
 		float DamageAmount = FallDamageCurve->GetFloatValue(FallHeight);
 		TakeDamage(DamageAmount, FDamageEvent(), GetController(), Hit.Actor.Get());
 	}
@@ -499,7 +523,7 @@ FGenericTeamId AGCBaseCharacter::GetGenericTeamId() const
 
 bool AGCBaseCharacter::CanJumpInternal_Implementation() const
 {
-	return Super::CanJumpInternal_Implementation() && !GetBaseCharacterMovementComponent()->IsMantling() && !GetBaseCharacterMovementComponent()->IsOnZipline();
+	return Super::CanJumpInternal_Implementation() && !GetBaseCharacterMovementComponent()->HasAnyMovementState(GCMovementState::JumpBlockers);
 }
 
 void AGCBaseCharacter::OnSprintStart_Implementation()
@@ -534,32 +558,23 @@ void AGCBaseCharacter::OnStopAimingInternal()
 
 bool AGCBaseCharacter::CanSprint()
 {
-	if (!GetBaseCharacterMovementComponent()->IsOutOfStamina() && !GetBaseCharacterMovementComponent()->IsSliding() && !GetBaseCharacterMovementComponent()->IsMantling() && !GetBaseCharacterMovementComponent()->IsWallRunning() && !GetBaseCharacterMovementComponent()->IsFalling() && !GetBaseCharacterMovementComponent()->IsCrouching())
-	{
-		return true;
-	}
-	else
-	{
-		return false;
-	}
+	return !GetBaseCharacterMovementComponent()->HasAnyMovementState(GCMovementState::SprintBlockers);
 }
 
 bool AGCBaseCharacter::CanSlide()
 {
-	//return GetBaseCharacterMovementComponent()->IsSprinting() && !GetBaseCharacterMovementComponent()->IsSwimming() && !GetBaseCharacterMovementComponent()->IsWallRunning();
-	return GetBaseCharacterMovementComponent()->IsWalking() && GetBaseCharacterMovementComponent()->IsSprinting();
+	const EMovementState SlideStates = EMovementState::Walking | EMovementState::Sprinting;
+	return (GetBaseCharacterMovementComponent()->GetMovementState() & SlideStates) == SlideStates;
 }
 
 bool AGCBaseCharacter::CanMantle() const
 {
-	return !GetBaseCharacterMovementComponent()->IsOnLadder() && !GetBaseCharacterMovementComponent()->IsMantling() && !GetBaseCharacterMovementComponent()->IsOnZipline() && !GetBaseCharacterMovementComponent()->IsOutOfStamina() && !GetBaseCharacterMovementComponent()->IsSliding() && !GetBaseCharacterMovementComponent()->IsFalling();
+	return !GetBaseCharacterMovementComponent()->HasAnyMovementState(GCMovementState::MantleBlockers);
 }
 
 bool AGCBaseCharacter::CanWallRun() const
 {
-	return !GetBaseCharacterMovementComponent()->IsOnLadder() && !GetBaseCharacterMovementComponent()->IsMantling()
-	&& !GetBaseCharacterMovementComponent()->IsOnZipline() && !GetBaseCharacterMovementComponent()->IsSwimming()
-	&& !GetBaseCharacterMovementComponent()->IsOnZipline() && !GetBaseCharacterMovementComponent()->IsOutOfStamina();
+	return !GetBaseCharacterMovementComponent()->HasAnyMovementState(GCMovementState::WallRunBlockers);
 }
 
 bool AGCBaseCharacter::CanFire() const
@@ -575,16 +590,14 @@ bool AGCBaseCharacter::CanFire() const
 		}
 	}
 	
-	return GetCharacterAttributesComponent()->IsAlive() && !GetBaseCharacterMovementComponent()->IsOnLadder() && !GetBaseCharacterMovementComponent()->IsMantling()
-	&& !GetBaseCharacterMovementComponent()->IsOnZipline() && !GetBaseCharacterMovementComponent()->IsSwimming() 
-	&& !GetBaseCharacterMovementComponent()->IsFalling() && !GetBaseCharacterMovementComponent()->IsOutOfStamina()
-	&& !GetBaseCharacterMovementComponent()->IsSliding() && !bAnimMontage;
+	return GetCharacterAttributesComponent()->IsAlive() && !GetBaseCharacterMovementComponent()->HasAnyMovementState(GCMovementState::FireBlockers) && !bAnimMontage;
 }
 
 void AGCBaseCharacter::OnDeath()
 {
 	GetCharacterMovement()->DisableMovement();
 	DisableMeshRotation();
+	CharacterEquipmentComponent->ReleaseLoadout();
 	if (GetCharacterMovement()->IsInWater())
 	{
 		EnableRagdoll();
@@ -626,31 +639,17 @@ void AGCBaseCharacter::OnPlayerCapsuleHit(UPrimitiveComponent* HitComponent, AAc
 
 void AGCBaseCharacter::UpdateIKSettings(float DeltaSeconds)
 {
-	IKRightFootOffset = FMath::FInterpTo(IKRightFootOffset, GetIKOffsetForASocket(RightFootSocketName), DeltaSeconds, IKInterpSpeed);
-	IKLeftFootOffset = FMath::FInterpTo(IKLeftFootOffset, GetIKOffsetForASocket(LeftFootSocketName), DeltaSeconds, IKInterpSpeed);
-	IKPelvisOffset = FMath::FInterpTo(IKPelvisOffset, CalculateIKPelvisOffset(), DeltaSeconds, IKInterpSpeed);
+	UFootIKSubsystem* FootIKSubsystem = GetWorld()->GetSubsystem<UFootIKSubsystem>();
+	float InterpSpeed = IKInterpSpeed * IKInterpSpeedScale;
+	IKRightFootOffset = FMath::FInterpTo(IKRightFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 0), DeltaSeconds, InterpSpeed);
+	IKLeftFootOffset = FMath::FInterpTo(IKLeftFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 1), DeltaSeconds, InterpSpeed);
+	IKPelvisOffset = FMath::FInterpTo(IKPelvisOffset, CalculateIKPelvisOffset(), DeltaSeconds, InterpSpeed);
 }
 
-float AGCBaseCharacter::GetIKOffsetForASocket(const FName& SocketName)
+void AGCBaseCharacter::OnAnimTickRateChanged(int32 TickRate)
 {
-	float Result = 0.0f;
-
-	float CapsuleHalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-		
-	FVector SocketLocation = GetMesh()->GetSocketLocation(SocketName);
-	FVector TraceStart(SocketLocation.X, SocketLocation.Y, GetActorLocation().Z);
-	FVector TraceEnd = TraceStart - (CapsuleHalfHeight + IKTraceDistance) * FVector::UpVector;
-
-	FHitResult HitResult;
-	TArray<AActor*> IgnoredActors;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
-
-	FVector FootSizeBox = FVector(1.f, 10.f, 4.f);
-	if (UKismetSystemLibrary::BoxTraceSingle(GetWorld(), TraceStart, TraceEnd, FootSizeBox, GetMesh()->GetSocketRotation(SocketName), TraceType, true, IgnoredActors, EDrawDebugTrace::None, HitResult, true))
-	{
-		Result = TraceStart.Z - CapsuleHalfHeight - HitResult.Location.Z;
-	}
-	return Result;
+	// The pose samples the offsets every TickRate frames, slower smoothing spreads a probe result over those samples instead of popping
+	IKInterpSpeedScale = 1.0f / TickRate;
 }
 
 float AGCBaseCharacter::CalculateIKPelvisOffset()
@@ -58,7 +58,6 @@ struct FSlideSettings
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnAimingStateChanged, bool);
 
-class AInteractiveActor;
 class UGCBaseCharacterMovementComponent;
 class UCharacterAttributesComponent;
 class UCharacterEquipmentComponent;
@@ -71,8 +70,11 @@ public:
 	AGCBaseCharacter(const FObjectInitializer& ObjectInitializer);
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void PawnClientRestart() override;
 	
 	virtual void MoveForward(float Value) {};
 	virtual void MoveRight(float Value) {};
@@ -93,6 +95,9 @@ public:
 	virtual void StartSprint();
 	virtual void StopSprint();
 
+	// Server side sprint input of a remote owning client, applied at once so the move is simulated with it
+	void SetSprintRequestedByMove(bool bIsRequested);
+
 	virtual void Tick(float DeltaTime) override;
 
 	virtual void SwimForward(float Value) {};
@@ -143,10 +148,6 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	FORCEINLINE float GetIKPelvisOffset() const { return IKPelvisOffset; }
 
-	void RegisterInteractiveActor(AInteractiveActor* InteractiveActor);
-
-	void UnregisterInteractiveActor(AInteractiveActor* InteractiveActor);
-
 	void ClimbLadderUp(float Value);
 
 	void InteractWithLadder();
@@ -273,9 +274,13 @@ private:
 		
 	void UpdateIKSettings(float DeltaSeconds);
 
-	float GetIKOffsetForASocket(const FName& SocketName);
 	float CalculateIKPelvisOffset();
 
+	void OnAnimTickRateChanged(int32 TickRate);
+
+	int32 FootIKAgentId = INDEX_NONE;
+	float IKInterpSpeedScale = 1.0f;
+
 	float IKRightFootOffset = 0.0f;
 	float IKLeftFootOffset = 0.0f;
 	float IKPelvisOffset = 0.0f;
@@ -284,8 +289,6 @@ private:
 
 	const FMantlingSettings& GetMantlingSettings(float LedgeHeight) const;
 
-	TArray<AInteractiveActor*> AvailableInteractiveActors; 
-
 	FSlideSettings CurrentSlideSettings;
 
 	float DefaultCapsuleHalfHeight = 0.f;
@@ -3,7 +3,9 @@
 
 #include "SpiderPawn.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "Subsystems/AnimBudgetSubsystem.h"
+#include "Subsystems/FootIKSubsystem.h"
+#include "Subsystems/TickSignificanceSubsystem.h"
 
 
 
@@ -19,29 +21,39 @@ ASpiderPawn::ASpiderPawn()
 void ASpiderPawn::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
-	IKRightFrontFootOffset = FMath::FInterpTo(IKRightFrontFootOffset, GetIKOffsetForASocket(RightFrontFootSocketName), DeltaSeconds, IKInterpSpeed);
-	IKRightRearFootOffset = FMath::FInterpTo(IKRightRearFootOffset, GetIKOffsetForASocket(RightRearFootSocketName), DeltaSeconds, IKInterpSpeed);
-	IKLeftFrontFootOffset = FMath::FInterpTo(IKLeftFrontFootOffset, GetIKOffsetForASocket(LeftFrontFootSocketName), DeltaSeconds, IKInterpSpeed);
-	IKLeftRearFootOffset = FMath::FInterpTo(IKLeftRearFootOffset, GetIKOffsetForASocket(LeftRearFootSocketName), DeltaSeconds, IKInterpSpeed);
+	UFootIKSubsystem* FootIKSubsystem = GetWorld()->GetSubsystem<UFootIKSubsystem>();
+	float InterpSpeed = IKInterpSpeed * IKInterpSpeedScale;
+	IKRightFrontFootOffset = FMath::FInterpTo(IKRightFrontFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 0), DeltaSeconds, InterpSpeed);
+	IKRightRearFootOffset = FMath::FInterpTo(IKRightRearFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 1), DeltaSeconds, InterpSpeed);
+	IKLeftFrontFootOffset = FMath::FInterpTo(IKLeftFrontFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 2), DeltaSeconds, InterpSpeed);
+	IKLeftRearFootOffset = FMath::FInterpTo(IKLeftRearFootOffset, FootIKSubsystem->GetFootOffset(FootIKAgentId, 3), DeltaSeconds, InterpSpeed);
 }
 
-float ASpiderPawn::GetIKOffsetForASocket(const FName& SocketName)
+void ASpiderPawn::BeginPlay()
 {
-	float Result = 0.0f;
-
-	FVector SocketLocation = SkeletalMeshComponent->GetSocketLocation(SocketName);
-	FVector TraceStart(SocketLocation.X, SocketLocation.Y, GetActorLocation().Z);
-	FVector TraceEnd = TraceStart - IKTraceDistance * FVector::UpVector;
-
-	FHitResult HitResult;
-	ETraceTypeQuery TraceType = UEngineTypes::ConvertToTraceType(ECC_Visibility);
-	if (UKismetSystemLibrary::LineTraceSingle(GetWorld(), TraceStart, TraceEnd, TraceType, true, TArray<AActor*>(), EDrawDebugTrace::ForOneFrame, HitResult, true))
-	{
-		Result = (TraceEnd.Z - HitResult.Location.Z) / IKScale;
-	}
-	else if (UKismetSystemLibrary::LineTraceSingle(GetWorld(), TraceEnd, TraceEnd - IKTraceExtendDistance * FVector::UpVector, TraceType, true, TArray<AActor*>(), EDrawDebugTrace::ForOneFrame, HitResult, true))
-	{
-		Result = (TraceEnd.Z - HitResult.Location.Z) / IKScale;
-	}
-	return Result;
+	Super::BeginPlay();
+
+	FFootIKProbeSettings FootIKSettings;
+	FootIKSettings.TraceLength = IKTraceDistance + IKTraceExtendDistance;
+	FootIKSettings.ReferenceOffset = IKTraceDistance;
+	FootIKSettings.Scale = IKScale;
+	TArray<FName> FootSocketNames = { RightFrontFootSocketName, RightRearFootSocketName, LeftFrontFootSocketName, LeftRearFootSocketName };
+	FootIKAgentId = GetWorld()->GetSubsystem<UFootIKSubsystem>()->RegisterAgent(this, SkeletalMeshComponent, FootSocketNames, FootIKSettings);
+	GetWorld()->GetSubsystem<UAnimBudgetSubsystem>()->RegisterMesh(this, SkeletalMeshComponent, FootIKAgentId, FOnAnimTickRateChanged::CreateUObject(this, &ASpiderPawn::OnAnimTickRateChanged));
+
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->RegisterActor(this);
+}
+
+void ASpiderPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetSubsystem<UAnimBudgetSubsystem>()->UnregisterMesh(this);
+	GetWorld()->GetSubsystem<UFootIKSubsystem>()->UnregisterAgent(FootIKAgentId);
+	FootIKAgentId = INDEX_NONE;
+	GetWorld()->GetSubsystem<UTickSignificanceSubsystem>()->UnregisterActor(this);
+	Super::EndPlay(EndPlayReason);
+}
+
+void ASpiderPawn::OnAnimTickRateChanged(int32 TickRate)
+{
+	IKInterpSpeedScale = 1.0f / TickRate;
 }
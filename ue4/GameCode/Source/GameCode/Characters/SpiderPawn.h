@@ -16,6 +16,9 @@ public:
 
 	virtual void Tick(float DeltaSeconds) override;
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	FORCEINLINE float GetIKRightFrontFootOffset() const { return IKRightFrontFootOffset; }
 
@@ -51,8 +54,6 @@ protected:
 	float IKInterpSpeed = 20.0f;
 
 private:
-	float GetIKOffsetForASocket(const FName& SocketName);
-
 	float IKRightFrontFootOffset = 0.0f;
 	float IKRightRearFootOffset = 0.0f;
 	float IKLeftFrontFootOffset = 0.0f;
@@ -61,4 +62,9 @@ private:
 	float IKTraceDistance = 0.0f;
 	float IKScale = 0.0f;
 
+	void OnAnimTickRateChanged(int32 TickRate);
+
+	int32 FootIKAgentId = INDEX_NONE;
+	float IKInterpSpeedScale = 1.0f;
+
 };
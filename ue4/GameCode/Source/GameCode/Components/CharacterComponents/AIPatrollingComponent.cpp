@@ -12,29 +12,14 @@ bool UAIPatrollingComponent::CanPatrol() const
 
 FVector UAIPatrollingComponent::SelectClosestWayPoint()
 {
-	FVector OwnerLocation = GetOwner()->GetActorLocation();
-	const TArray<FVector> WayPoints = PatrolSettings.PatrollingPath->GetWayPoints();
-	FTransform PathTransform = PatrolSettings.PatrollingPath->GetActorTransform();
-
-	FVector ClosestWayPoint;
-	float MinSqDistance = FLT_MAX;
-	for (int32 i = 0; i < WayPoints.Num(); ++i)
-	{
-		FVector WayPointWorld = PathTransform.TransformPosition(WayPoints[i]);
-		float CurrentSqDistance = (OwnerLocation - WayPointWorld).SizeSquared();
-		if (CurrentSqDistance < MinSqDistance)
-		{
-			MinSqDistance = CurrentSqDistance;
-			ClosestWayPoint = WayPointWorld;
-			CurrentWayPointIndex = i;
-		}
-	}
-	return  ClosestWayPoint;
+	const APatrollingPath* PatrollingPath = PatrolSettings.PatrollingPath;
+	CurrentWayPointIndex = PatrollingPath->FindClosestWayPoint(GetOwner()->GetActorLocation());
+	return PatrollingPath->GetWorldWayPoints()[CurrentWayPointIndex];
 }
 
 FVector UAIPatrollingComponent::SelectNextWayPoint()
 {
-	const TArray<FVector> WayPoints = PatrolSettings.PatrollingPath->GetWayPoints();
+	const TArray<FVector>& WayPoints = PatrolSettings.PatrollingPath->GetWorldWayPoints();
 
 	switch (PatrolSettings.PatrolMode)
 	{
@@ -70,8 +55,5 @@ FVector UAIPatrollingComponent::SelectNextWayPoint()
 		}
 	}
 	
-	FTransform PathTransform = PatrolSettings.PatrollingPath->GetActorTransform();
-	FVector WayPoint = PathTransform.TransformPosition(WayPoints[CurrentWayPointIndex]);
-	
-	return WayPoint;
+	return WayPoints[CurrentWayPointIndex];
 }
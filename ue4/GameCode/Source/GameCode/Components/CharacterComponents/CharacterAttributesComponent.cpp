@@ -3,6 +3,7 @@
 
 #include "CharacterAttributesComponent.h"
 #include "Characters/GCBaseCharacter.h"
+#include "Subsystems/DamageSubsystem.h"
 #include "Subsystems/DebugSubsystem.h"
 #include "Kismet/GameplayStatics.h"
 #include "DrawDebugHelpers.h"
@@ -13,10 +14,37 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogAttributes, Display, Display)
 
+void FAnalyticAttribute::Reset(float Time, float NewValue, float NewRate)
+{
+	Value = FMath::Clamp(NewValue, 0.0f, MaxValue);
+	Rate = NewRate;
+	Timestamp = Time;
+}
+
+void FAnalyticAttribute::SetRate(float Time, float NewRate)
+{
+	Reset(Time, Evaluate(Time), NewRate);
+}
+
+float FAnalyticAttribute::GetTimeToBound(float Time) const
+{
+	float CurrentValue = Evaluate(Time);
+	if (Rate < 0.0f && CurrentValue > 0.0f)
+	{
+		return CurrentValue / -Rate;
+	}
+	if (Rate > 0.0f && CurrentValue < MaxValue)
+	{
+		return (MaxValue - CurrentValue) / Rate;
+	}
+	return -1.0f;
+}
+
 // Sets default values for this component's properties
 UCharacterAttributesComponent::UCharacterAttributesComponent()
 {
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UCharacterAttributesComponent::BeginPlay()
@@ -28,8 +56,45 @@ void UCharacterAttributesComponent::BeginPlay()
 	CachedBaseCharacterOwner = StaticCast<AGCBaseCharacter*>(GetOwner());
 	CachedBaseCharacterOwner->OnTakeAnyDamage.AddDynamic(this, &UCharacterAttributesComponent::OnTakeAnyDamage);
 	Health = MaxHealth;
-	Stamina = MaxStamina;
-	Oxygen = MaxOxygen;
+
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+	Stamina.MaxValue = MaxStamina;
+	Stamina.Reset(CurrentTime, MaxStamina, StaminaRestoreVelocity);
+	Oxygen.MaxValue = MaxOxygen;
+	Oxygen.Reset(CurrentTime, MaxOxygen, OxygenRestoreVelocity);
+
+	SprintStateChangedHandle = CachedBaseCharacterOwner->GetBaseCharacterMovementComponent()->OnSprintStateChanged.AddUObject(this, &UCharacterAttributesComponent::OnSprintStateChanged);
+	CachedBaseCharacterOwner->MovementModeChangedDelegate.AddDynamic(this, &UCharacterAttributesComponent::OnMovementModeChanged);
+
+#if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
+	UDebugSubsystem* DebugSubsystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UDebugSubsystem>();
+	DebugCategoryChangedHandle = DebugSubsystem->OnDebugCategoryChanged.AddUObject(this, &UCharacterAttributesComponent::OnDebugCategoryChanged);
+	SetComponentTickEnabled(DebugSubsystem->IsCategoryEnabled(DebugCategoryCharacterAttributes));
+#endif
+}
+
+void UCharacterAttributesComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetTimerManager().ClearAllTimersForObject(this);
+	if (CachedBaseCharacterOwner.IsValid())
+	{
+		CachedBaseCharacterOwner->GetBaseCharacterMovementComponent()->OnSprintStateChanged.Remove(SprintStateChangedHandle);
+		CachedBaseCharacterOwner->MovementModeChangedDelegate.RemoveDynamic(this, &UCharacterAttributesComponent::OnMovementModeChanged);
+	}
+
+#if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(GetWorld());
+	if (IsValid(GameInstance))
+	{
+		GameInstance->GetSubsystem<UDebugSubsystem>()->OnDebugCategoryChanged.Remove(DebugCategoryChangedHandle);
+	}
+#endif
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UCharacterAttributesComponent::IsOutOfOxygen() const
+{
+	return Oxygen.Evaluate(GetWorld()->GetTimeSeconds()) == 0.0f;
 }
 
 #if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
@@ -45,65 +110,118 @@ void UCharacterAttributesComponent::DebugDrawAttributes()
 	DrawDebugString(GetWorld(), HealthTextLocation, FString::Printf(TEXT("Health: %.2f"), Health), nullptr, FColor::Green, 0.f, true);
 
 	FVector StaminaTextLocation = HealthTextLocation + DebugLinesOffset * FVector::DownVector;
-	DrawDebugString(GetWorld(), StaminaTextLocation, FString::Printf(TEXT("Stamina: %.2f"), Stamina), nullptr, FColor::Blue, 0.f, true);
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+	DrawDebugString(GetWorld(), StaminaTextLocation, FString::Printf(TEXT("Stamina: %.2f"), Stamina.Evaluate(CurrentTime)), nullptr, FColor::Blue, 0.f, true);
 
-	if (CachedBaseCharacterOwner->GetBaseCharacterMovementComponent()->IsSwimming() || Oxygen < MaxOxygen)
+	float CurrentOxygen = Oxygen.Evaluate(CurrentTime);
+	if (CachedBaseCharacterOwner->GetBaseCharacterMovementComponent()->IsSwimming() || CurrentOxygen < MaxOxygen)
 	{
 		FVector OxygenTextLocation = StaminaTextLocation + DebugLinesOffset * FVector::DownVector;
-		DrawDebugString(GetWorld(), OxygenTextLocation, FString::Printf(TEXT("Oxygen: %.2f"), Oxygen), nullptr, FColor::Cyan, 0.f, true);
+		DrawDebugString(GetWorld(), OxygenTextLocation, FString::Printf(TEXT("Oxygen: %.2f"), CurrentOxygen), nullptr, FColor::Cyan, 0.f, true);
+	}
+}
+
+void UCharacterAttributesComponent::OnDebugCategoryChanged(const FName& CategoryName, bool bIsEnabled)
+{
+	if (CategoryName == DebugCategoryCharacterAttributes)
+	{
+		SetComponentTickEnabled(bIsEnabled);
 	}
 }
 #endif
 
-void UCharacterAttributesComponent::UpdateStaminaValue(float DeltaSeconds)
+void UCharacterAttributesComponent::OnSprintStateChanged(bool bIsSprinting)
+{
+	Stamina.SetRate(GetWorld()->GetTimeSeconds(), bIsSprinting ? -SprintStaminaConsumptionVelocity : StaminaRestoreVelocity);
+	ScheduleStaminaBound();
+}
+
+void UCharacterAttributesComponent::ScheduleStaminaBound()
 {
-	if (CachedBaseCharacterOwner->GetBaseCharacterMovementComponent()->IsSprinting())
+	float TimeToBound = Stamina.GetTimeToBound(GetWorld()->GetTimeSeconds());
+	if (TimeToBound > 0.0f)
 	{
-		Stamina -= SprintStaminaConsumptionVelocity * DeltaSeconds;
-		Stamina = FMath::Clamp(Stamina, 0.0f, MaxStamina);
+		GetWorld()->GetTimerManager().SetTimer(StaminaBoundTimer, this, &UCharacterAttributesComponent::OnStaminaBoundReached, TimeToBound, false);
 	}
 	else
 	{
-		Stamina += StaminaRestoreVelocity * DeltaSeconds;
-		Stamina = FMath::Clamp(Stamina, 0.0f, MaxStamina);
+		GetWorld()->GetTimerManager().ClearTimer(StaminaBoundTimer);
 	}
+}
+
+void UCharacterAttributesComponent::OnStaminaBoundReached()
+{
+	// Timer may fire a bit early or late, the value is snapped to the bound it was scheduled for
+	bool bIsOutOfStamina = Stamina.Rate < 0.0f;
+	Stamina.Reset(GetWorld()->GetTimeSeconds(), bIsOutOfStamina ? 0.0f : MaxStamina, Stamina.Rate);
 
-	if (Stamina == 0.0f)
+	// Running out stops the sprint, which sets the restore rate and schedules the next bound
+	OutOfStaminaEvent.Broadcast(bIsOutOfStamina);
+}
+
+void UCharacterAttributesComponent::OnMovementModeChanged(ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	if (Character->GetCharacterMovement()->IsSwimming())
 	{
-		if (OutOfStaminaEvent.IsBound())
+		if (!TimerManager.IsTimerActive(UnderwaterCheckTimer))
 		{
-			OutOfStaminaEvent.Broadcast(true);
+			TimerManager.SetTimer(UnderwaterCheckTimer, this, &UCharacterAttributesComponent::UpdateUnderwaterState, UnderwaterCheckInterval, true);
 		}
 	}
-	if (Stamina == MaxStamina)
+	else
 	{
-		if (OutOfStaminaEvent.IsBound())
-		{
-			OutOfStaminaEvent.Broadcast(false);
-		}
+		TimerManager.ClearTimer(UnderwaterCheckTimer);
 	}
+	UpdateUnderwaterState();
 }
 
-void UCharacterAttributesComponent::UpdateOxygenValue(float DeltaTime)
+void UCharacterAttributesComponent::UpdateUnderwaterState()
 {
-	if (CachedBaseCharacterOwner->IsSwimmingUnderwater())
+	bool bIsUnderwaterNow = CachedBaseCharacterOwner->IsSwimmingUnderwater();
+	if (bIsUnderwaterNow == bIsUnderwater)
 	{
-		if (IsOutOfOxygen() && !GetWorld()->GetTimerManager().IsTimerActive(SwimDamageTimer))
-		{
-			GetWorld()->GetTimerManager().SetTimer(SwimDamageTimer, this, &UCharacterAttributesComponent::ApplySuffocationDamage, OutOfOxygenDamageInterval, true);
-		}
+		return;
+	}
 
-		Oxygen -= SwimOxygenConsumptionVelocity * DeltaTime;
-		Oxygen = FMath::Clamp(Oxygen, 0.f, MaxOxygen);
+	bIsUnderwater = bIsUnderwaterNow;
+	Oxygen.SetRate(GetWorld()->GetTimeSeconds(), bIsUnderwater ? -SwimOxygenConsumptionVelocity : OxygenRestoreVelocity);
+	if (!bIsUnderwater)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(SwimDamageTimer);
+	}
+	ScheduleOxygenBound();
+}
+
+void UCharacterAttributesComponent::ScheduleOxygenBound()
+{
+	// Only running out of oxygen matters, refilling it has no event
+	float TimeToBound = bIsUnderwater ? Oxygen.GetTimeToBound(GetWorld()->GetTimeSeconds()) : -1.0f;
+	if (TimeToBound > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(OxygenBoundTimer, this, &UCharacterAttributesComponent::OnOxygenBoundReached, TimeToBound, false);
 	}
 	else
 	{
-		if (GetWorld()->GetTimerManager().IsTimerActive(SwimDamageTimer))
+		GetWorld()->GetTimerManager().ClearTimer(OxygenBoundTimer);
+		if (bIsUnderwater)
 		{
-			GetWorld()->GetTimerManager().ClearTimer(SwimDamageTimer);
+			OnOxygenBoundReached();
 		}
-		Oxygen += OxygenRestoreVelocity * DeltaTime;
-		Oxygen = FMath::Clamp(Oxygen, 0.f, MaxOxygen);
+	}
+}
+
+void UCharacterAttributesComponent::OnOxygenBoundReached()
+{
+	if (!bIsUnderwater)
+	{
+		return;
+	}
+
+	Oxygen.Reset(GetWorld()->GetTimeSeconds(), 0.0f, Oxygen.Rate);
+	if (!GetWorld()->GetTimerManager().IsTimerActive(SwimDamageTimer))
+	{
+		GetWorld()->GetTimerManager().SetTimer(SwimDamageTimer, this, &UCharacterAttributesComponent::ApplySuffocationDamage, OutOfOxygenDamageInterval, true);
 	}
 }
 
@@ -114,12 +232,11 @@ void UCharacterAttributesComponent::OnTakeAnyDamage(AActor* DamagedActor, float
 		return;
 	}
 
-	UE_LOG(LogDamage, Warning, TEXT("UCharacterAttributesComponent::OnTakeAnyDamage %s recieved %.2f amount of damage from %s"), *CachedBaseCharacterOwner->GetName(), Damage, *DamageCauser->GetName());
 	Health = FMath::Clamp(Health - Damage, 0.f, MaxHealth); 
 
 	if (Health <= 0.f)
 	{
-		UE_LOG(LogDamage, Warning, TEXT("UCharacterAttributesComponent::OnTakeAnyDamage character %s is killed by: %s"), *CachedBaseCharacterOwner->GetName(), *DamageCauser->GetName());
+		UE_LOG(LogDamage, Verbose, TEXT("UCharacterAttributesComponent::OnTakeAnyDamage character %s is killed by: %s"), *CachedBaseCharacterOwner->GetName(), *GetNameSafe(DamageCauser));
 		if (OnDeathEvent.IsBound())
 		{
 			OnDeathEvent.Broadcast();
@@ -131,9 +248,6 @@ void UCharacterAttributesComponent::TickComponent(float DeltaTime, ELevelTick Ti
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	UpdateStaminaValue(DeltaTime);
-	UpdateOxygenValue(DeltaTime);
-
 #if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
 	DebugDrawAttributes();
 #endif
@@ -146,5 +260,5 @@ float UCharacterAttributesComponent::GetHealthPercent() const
 
 void UCharacterAttributesComponent::ApplySuffocationDamage()
 {
-	GetOwner()->TakeDamage(OutOfOxygenDamageAmount, FDamageEvent(), CachedBaseCharacterOwner->GetController(), CachedBaseCharacterOwner.Get());
+	GetWorld()->GetSubsystem<UDamageSubsystem>()->SubmitDamage(GetOwner(), OutOfOxygenDamageAmount, CachedBaseCharacterOwner->GetController(), CachedBaseCharacterOwner.Get());
 }
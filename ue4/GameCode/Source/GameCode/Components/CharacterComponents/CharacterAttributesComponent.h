@@ -9,6 +9,24 @@
 DECLARE_MULTICAST_DELEGATE(FOnDeathEventSignature);
 DECLARE_MULTICAST_DELEGATE_OneParam(FOutOfStaminaEventSignature, bool);
 
+/**
+ * Attribute changing at a constant rate between rate changes, evaluated on read instead of integrated every frame
+ */
+struct FAnalyticAttribute
+{
+	float Value = 0.0f;
+	float Rate = 0.0f;
+	float MaxValue = 0.0f;
+	float Timestamp = 0.0f;
+
+	float Evaluate(float Time) const { return FMath::Clamp(Value + Rate * (Time - Timestamp), 0.0f, MaxValue); }
+	void Reset(float Time, float NewValue, float NewRate);
+	void SetRate(float Time, float NewRate);
+
+	// Seconds until the value reaches 0 or MaxValue, negative if it stays where it is
+	float GetTimeToBound(float Time) const;
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class GAMECODE_API UCharacterAttributesComponent : public UActorComponent
 {
@@ -17,6 +35,7 @@ class GAMECODE_API UCharacterAttributesComponent : public UActorComponent
 public:	
 	UCharacterAttributesComponent();
 
+	// Ticks only to draw debug attributes
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	FOnDeathEventSignature OnDeathEvent;
@@ -25,12 +44,13 @@ public:
 
 	bool IsAlive() { return Health > 0.f; }
 
-	bool IsOutOfOxygen() { return Oxygen == 0.f; }
+	bool IsOutOfOxygen() const;
 
 	float GetHealthPercent() const;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug draw", meta = (UIMin = 0.f))
 	float DebugTextOffset = 15.0f;
@@ -65,21 +85,39 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Oxygen", meta = (UIMin = 0.f))
 	float OutOfOxygenDamageInterval = 1.0f;
 
+	// Head goes in and out of the water without a movement mode change, so it's checked with this interval while swimming
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Oxygen", meta = (ClampMin = 0.01f, UIMin = 0.01f))
+	float UnderwaterCheckInterval = 0.1f;
+
 private: 
 	float Health = 0.f;
-	float Stamina = 0.0f;
-	float Oxygen = 0.f;
+	FAnalyticAttribute Stamina;
+	FAnalyticAttribute Oxygen;
+
+	bool bIsUnderwater = false;
 
 #if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
 	void DebugDrawAttributes();
 #endif
 
-	void UpdateStaminaValue(float DeltaSeconds);
+	void OnSprintStateChanged(bool bIsSprinting);
+	void ScheduleStaminaBound();
+	void OnStaminaBoundReached();
 
-	void UpdateOxygenValue(float DeltaTime);
+	UFUNCTION()
+	void OnMovementModeChanged(ACharacter* Character, EMovementMode PrevMovementMode, uint8 PreviousCustomMode);
+	void UpdateUnderwaterState();
+	void ScheduleOxygenBound();
+	void OnOxygenBoundReached();
 
 	void ApplySuffocationDamage();
 
+#if UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT
+	void OnDebugCategoryChanged(const FName& CategoryName, bool bIsEnabled);
+
+	FDelegateHandle DebugCategoryChangedHandle;
+#endif
+
 	UFUNCTION()
 	void OnTakeAnyDamage(AActor* DamagedActor, float Damage, const class UDamageType* DamageType, class AController* InstigatedBy, AActor* DamageCauser);
 
@@ -87,4 +125,8 @@ private:
 	TWeakObjectPtr<class UGCBaseCharacterMovementComponent> CachedBaseCharacterMovement;
 
 	FTimerHandle SwimDamageTimer;
+	FTimerHandle StaminaBoundTimer;
+	FTimerHandle OxygenBoundTimer;
+	FTimerHandle UnderwaterCheckTimer;
+	FDelegateHandle SprintStateChangedHandle;
 };
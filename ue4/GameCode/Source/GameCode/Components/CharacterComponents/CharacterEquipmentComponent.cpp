@@ -4,6 +4,8 @@
 #include "CharacterEquipmentComponent.h"
 #include "Actors/Equipment/Weapons/RangeWeaponItem.h"
 #include "Characters/GCBaseCharacter.h"
+#include "Subsystems/AssetStreamingSubsystem.h"
+#include "Subsystems/EquipmentPoolSubsystem.h"
 #include <GameCodeTypes.h>
 
 
@@ -16,6 +18,16 @@ void UCharacterEquipmentComponent::BeginPlay()
 	AutoEquip();
 }
 
+void UCharacterEquipmentComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Items left on level streaming or world teardown are destroyed together with the level
+	if (EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		ReleaseLoadout();
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 EEquipableItemType UCharacterEquipmentComponent::GetCurrentEquippedItemType() const
 {
 	EEquipableItemType Result = EEquipableItemType::None;
@@ -65,7 +77,8 @@ void UCharacterEquipmentComponent::AttachCurrentItemToEquippedSocket()
 
 void UCharacterEquipmentComponent::EquipItemInSlot(EEquipmentSlots Slot)
 {
-	if (bIsEquipping)
+	// Loadout is empty once it's released
+	if (bIsEquipping || !ItemsArray.IsValidIndex((uint32)Slot))
 	{
 		return;
 	}
@@ -96,18 +109,19 @@ void UCharacterEquipmentComponent::EquipItemInSlot(EEquipmentSlots Slot)
 		OnCurrentWeaponReloadHandle = CurrentEquippedWeapon->OnReloadComplete.AddUFunction(this, FName("OnWeaponReloadComplete"));
 		OnCurrentWeaponAmmoChanged(CurrentEquippedWeapon->GetAmmo());
 	}
+	OnCurrentWeaponChangedEvent.Broadcast(CurrentEquippedWeapon);
+	UpdateItemsStreaming();
 }
 
 void UCharacterEquipmentComponent::EquipNextItem()
 {
-	uint32 CurrentSlotIndex = (uint32)CurrentEquippedSlot;
-	uint32 NextSlotIndex = NextItemsArraySlotIndex(CurrentSlotIndex);
-	
-	while (CurrentSlotIndex != NextSlotIndex && !IsValid(ItemsArray[NextSlotIndex]))
+	if (ItemsArray.Num() == 0)
 	{
-		NextSlotIndex = NextItemsArraySlotIndex(NextSlotIndex);
+		return;
 	}
 
+	uint32 CurrentSlotIndex = (uint32)CurrentEquippedSlot;
+	uint32 NextSlotIndex = FindNextItemSlotIndex(CurrentSlotIndex);
 	if (CurrentSlotIndex != NextSlotIndex)
 	{
 		EquipItemInSlot((EEquipmentSlots)NextSlotIndex);
@@ -116,14 +130,13 @@ void UCharacterEquipmentComponent::EquipNextItem()
 
 void UCharacterEquipmentComponent::EquipPreviousItem()
 {
-	uint32 CurrentSlotIndex = (uint32)CurrentEquippedSlot;
-	uint32 PreviousSlotIndex = PreviousItemsArraySlotIndex(CurrentSlotIndex);
-
-	while (CurrentSlotIndex != PreviousSlotIndex && !IsValid(ItemsArray[PreviousSlotIndex]))
+	if (ItemsArray.Num() == 0)
 	{
-		PreviousSlotIndex = PreviousItemsArraySlotIndex(PreviousSlotIndex);
+		return;
 	}
 
+	uint32 CurrentSlotIndex = (uint32)CurrentEquippedSlot;
+	uint32 PreviousSlotIndex = FindPreviousItemSlotIndex(CurrentSlotIndex);
 	if (CurrentSlotIndex != PreviousSlotIndex)
 	{
 		EquipItemInSlot((EEquipmentSlots)PreviousSlotIndex);
@@ -144,17 +157,46 @@ void UCharacterEquipmentComponent::CreateLoadout()
 	}
 
 	ItemsArray.AddZeroed((uint32)EEquipmentSlots::MAX);
+	UEquipmentPoolSubsystem* EquipmentPool = GetWorld()->GetSubsystem<UEquipmentPoolSubsystem>();
 	for (const TPair<EEquipmentSlots, TSubclassOf<AEquipableItem>>& ItemPair : ItemsLoadout)
 	{
 		if (!IsValid(ItemPair.Value))
 		{
 			continue;
 		}
-		AEquipableItem* Item = GetWorld()->SpawnActor<AEquipableItem>(ItemPair.Value);
-		Item->AttachToComponent(CachedBaseCharacter->GetMesh(), FAttachmentTransformRules::KeepRelativeTransform, Item->GetUnequippedSocketName());
-		Item->SetOwner(CachedBaseCharacter.Get());
+		AEquipableItem* Item = EquipmentPool->AcquireItem(ItemPair.Value, CachedBaseCharacter.Get());
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+		Item->AttachToComponent(CachedBaseCharacter->GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, Item->GetUnequippedSocketName());
 		ItemsArray[(uint32)ItemPair.Key] = Item;
 	}
+	UpdateItemsStreaming();
+}
+
+void UCharacterEquipmentComponent::ReleaseLoadout()
+{
+	if (ItemsArray.Num() == 0)
+	{
+		return;
+	}
+
+	UnequipCurrentItem();
+	GetWorld()->GetTimerManager().ClearTimer(EquipTimer);
+	bIsEquipping = false;
+	CurrentEquippedItem = nullptr;
+	CurrentEquippedWeapon = nullptr;
+	OnCurrentWeaponChangedEvent.Broadcast(nullptr);
+
+	UAssetStreamingSubsystem* AssetStreaming = GetWorld()->GetGameInstance()->GetSubsystem<UAssetStreamingSubsystem>();
+	UEquipmentPoolSubsystem* EquipmentPool = GetWorld()->GetSubsystem<UEquipmentPoolSubsystem>();
+	for (AEquipableItem* Item : ItemsArray)
+	{
+		AssetStreaming->ReleaseAssets(Item);
+		EquipmentPool->ReleaseItem(Item);
+	}
+	ItemsArray.Reset();
 }
 
 void UCharacterEquipmentComponent::AutoEquip()
@@ -195,6 +237,55 @@ uint32 UCharacterEquipmentComponent::PreviousItemsArraySlotIndex(uint32 CurrentS
 	}
 }
 
+uint32 UCharacterEquipmentComponent::FindNextItemSlotIndex(uint32 CurrentSlotIndex)
+{
+	uint32 NextSlotIndex = NextItemsArraySlotIndex(CurrentSlotIndex);
+	while (CurrentSlotIndex != NextSlotIndex && !IsValid(ItemsArray[NextSlotIndex]))
+	{
+		NextSlotIndex = NextItemsArraySlotIndex(NextSlotIndex);
+	}
+	return NextSlotIndex;
+}
+
+uint32 UCharacterEquipmentComponent::FindPreviousItemSlotIndex(uint32 CurrentSlotIndex)
+{
+	uint32 PreviousSlotIndex = PreviousItemsArraySlotIndex(CurrentSlotIndex);
+	while (CurrentSlotIndex != PreviousSlotIndex && !IsValid(ItemsArray[PreviousSlotIndex]))
+	{
+		PreviousSlotIndex = PreviousItemsArraySlotIndex(PreviousSlotIndex);
+	}
+	return PreviousSlotIndex;
+}
+
+void UCharacterEquipmentComponent::UpdateItemsStreaming()
+{
+	UAssetStreamingSubsystem* AssetStreaming = GetWorld()->GetGameInstance()->GetSubsystem<UAssetStreamingSubsystem>();
+	uint32 CurrentSlotIndex = (uint32)CurrentEquippedSlot;
+	uint32 NextSlotIndex = FindNextItemSlotIndex(CurrentSlotIndex);
+	uint32 PreviousSlotIndex = FindPreviousItemSlotIndex(CurrentSlotIndex);
+
+	TArray<FSoftObjectPath> Assets;
+	for (uint32 SlotIndex = 0; SlotIndex < (uint32)ItemsArray.Num(); ++SlotIndex)
+	{
+		AEquipableItem* Item = ItemsArray[SlotIndex];
+		if (!IsValid(Item))
+		{
+			continue;
+		}
+
+		if (Item == CurrentEquippedItem || SlotIndex == NextSlotIndex || SlotIndex == PreviousSlotIndex)
+		{
+			Assets.Reset();
+			Item->GetStreamedAssets(Assets);
+			AssetStreaming->RequestAssets(Item, Assets, Item == CurrentEquippedItem ? EAssetStreamingReason::InUse : EAssetStreamingReason::Prefetch);
+		}
+		else
+		{
+			AssetStreaming->ReleaseAssets(Item);
+		}
+	}
+}
+
 int32 UCharacterEquipmentComponent::GetAvailableAmunitionForCurrentWeapon() const
 {
 	checkf(IsValid(CurrentEquippedWeapon), TEXT(""));
@@ -12,6 +12,8 @@ typedef TArray<int32, TInlineAllocator<(uint8)EAmunitionType::MAX>> TAmuinitionA
 DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCurrentWeaponAmmoChanged, int32, int32);
 
 class ARangeWeaponItem;
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCurrentWeaponChanged, ARangeWeaponItem*);
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class GAMECODE_API UCharacterEquipmentComponent : public UActorComponent
 {
@@ -23,6 +25,7 @@ public:
 	ARangeWeaponItem* GetCurrentRangeWeapon() const;
 
 	FOnCurrentWeaponAmmoChanged OnCurrentWeaponAmmoChangedEvent;
+	FOnCurrentWeaponChanged OnCurrentWeaponChangedEvent;
 
 	void ReloadCurrentWeapon();
 	void UnequipCurrentItem();
@@ -35,8 +38,12 @@ public:
 
 	bool IsEquipping() const;
 
+	// Returns every item of the loadout to the equipment pool
+	void ReleaseLoadout();
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Loadout")
 	TMap<EAmunitionType, int32> MaxAmunitionAmount;
@@ -59,6 +66,13 @@ private:
 	uint32 NextItemsArraySlotIndex(uint32 CurrentSlotIndex);
 	uint32 PreviousItemsArraySlotIndex(uint32 CurrentSlotIndex);
 
+	// Slot of the item EquipNextItem or EquipPreviousItem would equip, CurrentSlotIndex when there is none
+	uint32 FindNextItemSlotIndex(uint32 CurrentSlotIndex);
+	uint32 FindPreviousItemSlotIndex(uint32 CurrentSlotIndex);
+
+	// Assets of the equipped item are kept streamed in, the ones of the next and previous items are prefetched, the rest are released
+	void UpdateItemsStreaming();
+
 	int32 GetAvailableAmunitionForCurrentWeapon() const;
 
 	UFUNCTION()
@@ -5,9 +5,133 @@
 #include "GameFramework/Character.h"
 #include "Components/CapsuleComponent.h"
 #include "../GameCodeTypes.h"
+#include "../Utils/GCTelemetry.h"
+#include "../Utils/GCTraceUtils.h"
+#include "../Subsystems/InteractiveActorsSubsystem.h"
 #include "Widgets/Text/ISlateEditableTextWidget.h"
 
-DEFINE_LOG_CATEGORY_STATIC(LogBaseCharacterMovement, Display, Display)
+DECLARE_DWORD_COUNTER_STAT(TEXT("Custom movement substeps"), STAT_CustomMovementSubsteps, STATGROUP_GameCode);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Custom movement dropped time"), STAT_CustomMovementDroppedTime, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rejected client traversals"), STAT_RejectedClientTraversals, STATGROUP_GameCode);
+
+void FSavedMove_GC::Clear()
+{
+	Super::Clear();
+	SavedTraversalActorId = 0;
+	bSavedIsSprinting = 0;
+	bSavedIsSliding = 0;
+}
+
+uint8 FSavedMove_GC::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+	if (bSavedIsSprinting)
+	{
+		Result |= FLAG_Custom_0;
+	}
+	if (bSavedIsSliding)
+	{
+		Result |= FLAG_Custom_1;
+	}
+	return Result;
+}
+
+bool FSavedMove_GC::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_GC* NewGCMove = StaticCast<const FSavedMove_GC*>(NewMove.Get());
+	if (bSavedIsSprinting != NewGCMove->bSavedIsSprinting
+		|| bSavedIsSliding != NewGCMove->bSavedIsSliding
+		|| SavedTraversalActorId != NewGCMove->SavedTraversalActorId)
+	{
+		return false;
+	}
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_GC::SetMoveFor(ACharacter* InCharacter, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(InCharacter, InDeltaTime, NewAccel, ClientData);
+
+	const UGCBaseCharacterMovementComponent* MovementComponent = StaticCast<const UGCBaseCharacterMovementComponent*>(InCharacter->GetCharacterMovement());
+	bSavedIsSprinting = MovementComponent->IsSprinting();
+	bSavedIsSliding = MovementComponent->IsSliding();
+	SavedTraversalActorId = MovementComponent->GetTraversalActorId();
+}
+
+void FSavedMove_GC::PrepMoveFor(ACharacter* InCharacter)
+{
+	Super::PrepMoveFor(InCharacter);
+
+	UGCBaseCharacterMovementComponent* MovementComponent = StaticCast<UGCBaseCharacterMovementComponent*>(InCharacter->GetCharacterMovement());
+	if (bSavedIsSprinting)
+	{
+		MovementComponent->StartSprint();
+	}
+	else
+	{
+		MovementComponent->StopSprint();
+	}
+
+	// Slide goes after sprint, starting it requires sprinting
+	if (bSavedIsSliding != MovementComponent->IsSliding())
+	{
+		AGCBaseCharacter* BaseCharacter = StaticCast<AGCBaseCharacter*>(InCharacter);
+		if (bSavedIsSliding)
+		{
+			BaseCharacter->StartSlide();
+		}
+		else
+		{
+			BaseCharacter->StopSlide();
+		}
+	}
+}
+
+FNetworkPredictionData_Client_GC::FNetworkPredictionData_Client_GC(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_GC::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_GC());
+}
+
+void FGCCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+	TraversalActorId = StaticCast<const FSavedMove_GC&>(ClientMove).SavedTraversalActorId;
+}
+
+bool FGCCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Most moves are not on a ladder or zipline, those cost a single bit
+	bool bHasTraversalActor = TraversalActorId != 0;
+	Ar.SerializeBits(&bHasTraversalActor, 1);
+	if (bHasTraversalActor)
+	{
+		Ar << TraversalActorId;
+	}
+	else if (Ar.IsLoading())
+	{
+		TraversalActorId = 0;
+	}
+	return !Ar.IsError();
+}
+
+FGCCharacterNetworkMoveDataContainer::FGCCharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &GCMoveData[0];
+	PendingMoveData = &GCMoveData[1];
+	OldMoveData = &GCMoveData[2];
+}
+
+UGCBaseCharacterMovementComponent::UGCBaseCharacterMovementComponent()
+{
+	SetNetworkMoveDataContainer(GCNetworkMoveDataContainer);
+}
 
 void UGCBaseCharacterMovementComponent::PhysicsRotation(float DeltaTime)
 {
@@ -63,74 +187,223 @@ void UGCBaseCharacterMovementComponent::PhysicsRotation(float DeltaTime)
 
 }
 
-void UGCBaseCharacterMovementComponent::SetIsOutOfStamina(bool bIsOutOfStamina_In)
+FNetworkPredictionData_Client* UGCBaseCharacterMovementComponent::GetPredictionData_Client() const
 {
-	bIsOutOfStamina = bIsOutOfStamina_In;
-	if(bIsOutOfStamina)
+	if (ClientPredictionData == nullptr)
 	{
-		StopSprint();
-	}	
-	SetJumpAllowed(!bIsOutOfStamina_In);
+		UGCBaseCharacterMovementComponent* MutableThis = const_cast<UGCBaseCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_GC(*this);
+	}
+	return ClientPredictionData;
 }
 
-float UGCBaseCharacterMovementComponent::GetMaxSpeed() const
+void UGCBaseCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
 {
-	float Result = Super::GetMaxSpeed();
-	if (MovementMode == EMovementMode::MOVE_Falling)
-	{
-		return Result;
-	}
-	else if (MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Ladder)
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// Slide goes first, starting it requires the sprint of the previous move
+	bool bWantsToSlide = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+	if (CharacterOwner->GetLocalRole() == ROLE_Authority && bWantsToSlide != IsSliding())
 	{
-		if (bIsSprinting)
+		if (bWantsToSlide)
 		{
-			Result = ClimbingOnLadderMaxSpeed;
+			GetBaseCharacterOwner()->StartSlide();
 		}
 		else
 		{
-			Result = ClimbingOnLadderRegularSpeed;
+			GetBaseCharacterOwner()->StopSlide();
 		}
 	}
-	else if (MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_WallRun)
+
+	bool bWantsToSprint = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	if (CharacterOwner->GetLocalRole() == ROLE_Authority)
+	{
+		// Goes through the sprint request, so TryChangeSprintState stays the only place sprint starts or stops on the server
+		GetBaseCharacterOwner()->SetSprintRequestedByMove(bWantsToSprint);
+	}
+	else if (bWantsToSprint && !IsOutOfStamina())
+	{
+		StartSprint();
+	}
+	else if (!bWantsToSprint)
+	{
+		StopSprint();
+	}
+}
+
+void UGCBaseCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	// Client replays its own saved moves through here as well, attaching is already done on its side
+	if (CharacterOwner->GetLocalRole() == ROLE_Authority)
+	{
+		const FGCCharacterNetworkMoveData* MoveData = StaticCast<const FGCCharacterNetworkMoveData*>(GetCurrentNetworkMoveData());
+		if (MoveData != nullptr)
+		{
+			ApplyClientTraversal(MoveData->TraversalActorId, MoveData->MovementMode);
+		}
+	}
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+uint32 UGCBaseCharacterMovementComponent::GetTraversalActorId() const
+{
+	if (IsOnLadder() && IsValid(CurrentLadder))
+	{
+		return CurrentLadder->GetInteractiveActorId();
+	}
+	if (IsOnZipline() && IsValid(CurrentZipline))
+	{
+		return CurrentZipline->GetInteractiveActorId();
+	}
+	return 0;
+}
+
+void UGCBaseCharacterMovementComponent::ApplyClientTraversal(uint32 TraversalActorId, uint8 PackedMovementMode)
+{
+	uint32 CurrentTraversalActorId = GetTraversalActorId();
+	if (TraversalActorId == CurrentTraversalActorId)
+	{
+		return;
+	}
+
+	uint8 ClientMovementMode = MOVE_None;
+	uint8 ClientCustomMode = 0;
+	uint8 ClientGroundMode = MOVE_None;
+	UnpackNetworkMovementMode(PackedMovementMode, ClientMovementMode, ClientCustomMode, ClientGroundMode);
+
+	// Client has dropped off, the server follows it instead of staying attached until its own detach
+	if (CurrentTraversalActorId != 0)
 	{
-		if (bIsSprinting)
+		if (IsOnLadder())
 		{
-			Result = MaxWallRunSpeed;
+			EDettachFromLadderMethod DettachMethod = EDettachFromLadderMethod::Fall;
+			if (ClientMovementMode == MOVE_Walking)
+			{
+				DettachMethod = EDettachFromLadderMethod::ReachingTheBottom;
+			}
+			else if (ClientMovementMode == MOVE_Custom && ClientCustomMode == (uint8)ECustomMovementMode::CMOVE_Mantling)
+			{
+				DettachMethod = EDettachFromLadderMethod::ReachingTheTop;
+			}
+			DettachFromLadder(DettachMethod);
+		}
+		else if (IsOnZipline())
+		{
+			DettachFromZipline();
 		}
 	}
-	else if (GetBaseCharacterOwner()->IsAiming())
+
+	if (TraversalActorId == 0 || ClientMovementMode != MOVE_Custom)
 	{
-		Result = GetBaseCharacterOwner()->GetAimingMovementSpeed();
+		return;
+	}
+
+	const AInteractiveActor* TraversalActor = GetWorld()->GetSubsystem<UInteractiveActorsSubsystem>()->FindById(TraversalActorId);
+	// Client may only attach to what it could have reached itself
+	if (!IsValid(TraversalActor) || !TraversalActor->IsInReach(FInteractionReach(CharacterOwner)))
+	{
+		INC_DWORD_STAT(STAT_RejectedClientTraversals);
+		return;
+	}
+
+	const ALadder* Ladder = Cast<ALadder>(TraversalActor);
+	const AZipline* Zipline = Cast<AZipline>(TraversalActor);
+	if (ClientCustomMode == (uint8)ECustomMovementMode::CMOVE_Ladder && IsValid(Ladder))
+	{
+		AttachToLadder(Ladder);
+	}
+	else if (ClientCustomMode == (uint8)ECustomMovementMode::CMOVE_Zipline && IsValid(Zipline))
+	{
+		AttachToZipline(Zipline);
 	}
 	else
 	{
-		if (bIsOutOfStamina)
+		INC_DWORD_STAT(STAT_RejectedClientTraversals);
+	}
+}
+
+void UGCBaseCharacterMovementComponent::SetIsOutOfStamina(bool bIsOutOfStamina_In)
+{
+	SetMovementState(EMovementState::OutOfStamina, bIsOutOfStamina_In);
+	if(bIsOutOfStamina_In)
+	{
+		StopSprint();
+	}	
+	SetJumpAllowed(!bIsOutOfStamina_In);
+}
+
+void UGCBaseCharacterMovementComponent::SetIsAiming(bool bIsAiming)
+{
+	SetMovementState(EMovementState::Aiming, bIsAiming);
+}
+
+float UGCBaseCharacterMovementComponent::GetMaxSpeed() const
+{
+	float Result = Super::GetMaxSpeed();
+	switch (CurrentMovementModePolicy->SpeedPolicy)
+	{
+		case EMovementSpeedPolicy::Ladder:
 		{
-			Result = OutOfStaminaSpeed;
+			return IsSprinting() ? ClimbingOnLadderMaxSpeed : ClimbingOnLadderRegularSpeed;
 		}
-		else if (bIsSprinting)
+		case EMovementSpeedPolicy::WallRun:
 		{
-			Result = SprintSpeed;
+			return IsSprinting() ? MaxWallRunSpeed : Result;
 		}
+		case EMovementSpeedPolicy::Ground:
+		{
+			if (HasAnyMovementState(EMovementState::Aiming))
+			{
+				return GetBaseCharacterOwner()->GetAimingMovementSpeed();
+			}
+			if (IsOutOfStamina())
+			{
+				return OutOfStaminaSpeed;
+			}
+			return IsSprinting() ? SprintSpeed : Result;
+		}
+		default:
+			return Result;
 	}
-	return Result;
+}
+
+void UGCBaseCharacterMovementComponent::Crouch(bool bClientSimulation /*= false*/)
+{
+	Super::Crouch(bClientSimulation);
+	SetMovementState(EMovementState::Crouching, CharacterOwner->bIsCrouched);
+}
+
+void UGCBaseCharacterMovementComponent::UnCrouch(bool bClientSimulation /*= false*/)
+{
+	Super::UnCrouch(bClientSimulation);
+	SetMovementState(EMovementState::Crouching, CharacterOwner->bIsCrouched);
 }
 
 void UGCBaseCharacterMovementComponent::StartSprint()
 {
-	bIsSprinting = true;
+	bool bIsChanged = !IsSprinting();
+	SetMovementState(EMovementState::Sprinting, true);
 	bForceMaxAccel = 1;
+	if (bIsChanged)
+	{
+		OnSprintStateChanged.Broadcast(true);
+	}
 }
 
 void UGCBaseCharacterMovementComponent::StopSprint()
 {
-	bIsSprinting = false;
+	bool bIsChanged = IsSprinting();
+	SetMovementState(EMovementState::Sprinting, false);
 	bForceMaxAccel = 0;
+	if (bIsChanged)
+	{
+		OnSprintStateChanged.Broadcast(false);
+	}
 }
 
 void UGCBaseCharacterMovementComponent::StartSlide(FSlideSettings SlideSettings)
 {
-	bIsSliding = true;
+	SetMovementState(EMovementState::Sliding, true);
 	SlideSlowDownTimeline.PlayFromStart();
 	GetWorld()->GetTimerManager().SetTimer(SlidingTimer, GetBaseCharacterOwner(), &AGCBaseCharacter::StopSlide, SlideMaxTime, false);
 	SetMovementMode(EMovementMode::MOVE_None);
@@ -143,8 +416,7 @@ void UGCBaseCharacterMovementComponent::UpdateSlide(float DeltaTime, FSlideSetti
 		FHitResult LineTraceHit;
 		FVector LineTraceStart = GetBaseCharacterOwner()->GetActorLocation() - SlideSettings.SlideDirection * SlideOverLedgeOffset;
 		FVector LineTraceEnd = LineTraceStart + (GetBaseCharacterOwner()->GetDefaultHalfHeight() + SlideDownLineTraceLength) * FVector::DownVector;
-		FCollisionQueryParams QueryParams;
-		if (!GetWorld()->LineTraceSingleByChannel(LineTraceHit, LineTraceStart, LineTraceEnd, ECC_Visibility, QueryParams))
+		if (!GetWorld()->LineTraceSingleByChannel(LineTraceHit, LineTraceStart, LineTraceEnd, ECC_Visibility, OwnerQueryParams))
 		{
 			GetBaseCharacterOwner()->StopSlide();
 			Launch(CurrentSlideSpeed * SlideSettings.SlideDirection);
@@ -166,7 +438,7 @@ void UGCBaseCharacterMovementComponent::UpdateSlideSpeed(float Alpha)
 
 void UGCBaseCharacterMovementComponent::StopSlide(FSlideSettings SlideSettings)
 {
-	bIsSliding = false;
+	SetMovementState(EMovementState::Sliding, false);
 	SetMovementMode(EMovementMode::MOVE_Walking);
 	SlideSlowDownTimeline.Stop();
 	GetWorld()->GetTimerManager().ClearTimer(SlidingTimer);
@@ -184,24 +456,21 @@ void UGCBaseCharacterMovementComponent::EndMantle()
 	SetMovementMode(EMovementMode::MOVE_Walking);
 }
 
-bool UGCBaseCharacterMovementComponent::IsMantling() const
-{
-	return UpdatedComponent && MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Mantling;
-}
-
 void UGCBaseCharacterMovementComponent::AttachToLadder(const ALadder* Ladder)
 {
 	CurrentLadder = Ladder;
-	FRotator TargetOrientationRotation = CurrentLadder->GetActorForwardVector().ToOrientationRotator();
+	CurrentLadderSegment.Origin = CurrentLadder->GetActorLocation();
+	CurrentLadderSegment.UpVector = CurrentLadder->GetActorUpVector();
+	CurrentLadderSegment.ForwardVector = CurrentLadder->GetActorForwardVector();
+	CurrentLadderSegment.Height = CurrentLadder->GetLadderHeight();
+
+	FRotator TargetOrientationRotation = CurrentLadderSegment.ForwardVector.ToOrientationRotator();
 	TargetOrientationRotation.Yaw += 180.0f;
 
-	
-	FVector LadderUpVector = CurrentLadder->GetActorUpVector();
-	FVector LadderForwardVector = CurrentLadder->GetActorForwardVector();
 	float Projection = GetActorToCurrentLadderProjection(GetActorLocation());
 
-	FVector NewCharacterLocation = CurrentLadder->GetActorLocation() + Projection * LadderUpVector + LadderToCharacterOffset * LadderForwardVector;
-	if (CurrentLadder->GetIsOnTop())
+	FVector NewCharacterLocation = CurrentLadderSegment.Origin + Projection * CurrentLadderSegment.UpVector + LadderToCharacterOffset * CurrentLadderSegment.ForwardVector;
+	if (CurrentLadder->GetIsOnTop(FInteractionReach(CharacterOwner)))
 	{
 		NewCharacterLocation = CurrentLadder->GetAttachFromTopAnimMontageStartingLocation();
 	}
@@ -217,9 +486,7 @@ float UGCBaseCharacterMovementComponent::GetActorToCurrentLadderProjection(const
 {
 	checkf(IsValid(CurrentLadder), TEXT("float UGCBaseCharacterMovementComponent::GetCharacterToCurrentLadderProjection() can't be invoked, when current ladder is null"));
 
-	FVector LadderUpVector = CurrentLadder->GetActorUpVector();
-	FVector LadderCharacterDistance = Location - CurrentLadder->GetActorLocation();
-	return FVector::DotProduct(LadderUpVector, LadderCharacterDistance);
+	return FVector::DotProduct(CurrentLadderSegment.UpVector, Location - CurrentLadderSegment.Origin);
 }
 
 void UGCBaseCharacterMovementComponent::DettachFromLadder(EDettachFromLadderMethod DettachFromLadderMethod /*= EDettachFromLadderMethod::Fall*/)
@@ -228,7 +495,7 @@ void UGCBaseCharacterMovementComponent::DettachFromLadder(EDettachFromLadderMeth
 	{
 		case EDettachFromLadderMethod::JumpOff:
 		{
-			FVector JumpDirection = CurrentLadder->GetActorForwardVector();
+			FVector JumpDirection = CurrentLadderSegment.ForwardVector;
 			SetMovementMode(MOVE_Falling);
 
 			FVector JumpVelocity = JumpDirection * JumpOffFromLadderSpeed;
@@ -258,11 +525,6 @@ void UGCBaseCharacterMovementComponent::DettachFromLadder(EDettachFromLadderMeth
 	}
 }
 
-bool UGCBaseCharacterMovementComponent::IsOnLadder() const
-{
-	return UpdatedComponent && MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Ladder;
-}
-
 const class ALadder* UGCBaseCharacterMovementComponent::GetCurrentLadder()
 {
 	return CurrentLadder;
@@ -272,19 +534,21 @@ float UGCBaseCharacterMovementComponent::GetLadderSpeedRatio() const
 {
 	checkf(IsValid(CurrentLadder), TEXT("float UGCBaseCharacterMovementComponent::GetLadderSpeedRatio() can't be invoked, when current ladder is null"));
 
-	FVector LadderUpVector = CurrentLadder->GetActorUpVector();
-	return FVector::DotProduct(LadderUpVector, Velocity) / ClimbingOnLadderMaxSpeed;
+	return FVector::DotProduct(CurrentLadderSegment.UpVector, Velocity) / ClimbingOnLadderMaxSpeed;
 }
 
 void UGCBaseCharacterMovementComponent::AttachToZipline(const AZipline* Zipline)
 {
 	CurrentZipline = Zipline;
-	ZiplineDirection = GetCurrentZipline()->GetZiplineVector();
+	CurrentZiplineSegment.Direction = CurrentZipline->GetZiplineVector();
+	CurrentZiplineSegment.Start = CurrentZipline->GetZiplineAttachPoint(CharacterOwner);
+	CurrentZiplineSegment.Length = FVector::DotProduct(CurrentZipline->GetZiplineEndPoint() - CurrentZiplineSegment.Start, CurrentZiplineSegment.Direction);
+	CurrentZiplineSegment.TraveledDistance = 0.0f;
 
-	FRotator TargetOrientationRotation = ZiplineDirection.ToOrientationRotator();
+	FRotator TargetOrientationRotation = CurrentZiplineSegment.Direction.ToOrientationRotator();
 	TargetOrientationRotation.Pitch = 0.0f;
 	
-	FVector AttachPoint = CurrentZipline->GetZiplineAttachPoint(CharacterOwner);
+	FVector AttachPoint = CurrentZiplineSegment.Start;
 
 	float CharacterOwnerCapsuleHalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	float ZiplineToCharacterOffset = 35.0f;
@@ -294,7 +558,7 @@ void UGCBaseCharacterMovementComponent::AttachToZipline(const AZipline* Zipline)
 	GetOwner()->SetActorRotation(TargetOrientationRotation);
 	GetOwner()->SetActorLocation(NewCharacterLocation);
 
-	InitialZiplineSpeed = GetOwner()->GetVelocity().ProjectOnTo(ZiplineDirection).Size();
+	InitialZiplineSpeed = GetOwner()->GetVelocity().ProjectOnTo(CurrentZiplineSegment.Direction).Size();
 
 	ZiplineAccelerationTimeline.PlayFromStart();
 	SetMovementMode(MOVE_Custom, (uint8)ECustomMovementMode::CMOVE_Zipline);
@@ -309,11 +573,6 @@ void UGCBaseCharacterMovementComponent::DettachFromZipline()
 	SetMovementMode(MOVE_Falling);
 }
 
-bool UGCBaseCharacterMovementComponent::IsOnZipline() const
-{
-	return UpdatedComponent && MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Zipline;
-}
-
 const class AZipline* UGCBaseCharacterMovementComponent::GetCurrentZipline()
 {
 	return CurrentZipline;
@@ -336,6 +595,8 @@ void UGCBaseCharacterMovementComponent::StartWallRun(const FVector& HitNormal)
 
 	GetWallRunSideAndDirection(HitNormal, CurrentWallRunParameters.Side, CurrentWallRunParameters.Direction);
 	CurrentWallRunParameters.WallNormal = HitNormal;
+	FVector WallPoint = GetActorLocation() - CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() * HitNormal;
+	CurrentWallRunParameters.WallPlane = FPlane(WallPoint + WallRunUpdateLinetraceLength * HitNormal, HitNormal);
 	
 	FRotator TargetActorRotation = CurrentWallRunParameters.Direction.ToOrientationRotator();
 	GetOwner()->SetActorRotation(TargetActorRotation);
@@ -385,11 +646,6 @@ void UGCBaseCharacterMovementComponent::StopWallRun(EStopWallRunMethod StopWallR
 	}
 }
 
-bool UGCBaseCharacterMovementComponent::IsWallRunning() const
-{
-	return UpdatedComponent && MovementMode == MOVE_Custom && CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_WallRun;
-}
-
 FWallRunParameters UGCBaseCharacterMovementComponent::GetWallRunParameters() const
 {
 	return CurrentWallRunParameters;
@@ -399,6 +655,8 @@ void UGCBaseCharacterMovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	OwnerQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT_NAME_ONLY(GCCharacterMovement), false, GetOwner());
+
 	if (IsValid(ZiplineAccelTimelineCurve))
 	{
 		FOnTimelineFloatStatic ZiplineMovementTimelineUpdate;
@@ -415,6 +673,41 @@ void UGCBaseCharacterMovementComponent::BeginPlay()
 }
 
 void UGCBaseCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	// Mantling samples its curve by the elapsed time, splitting the frame gives the same result
+	if (!bUseCustomMovementSubstepping || CustomMovementMode == (uint8)ECustomMovementMode::CMOVE_Mantling)
+	{
+		CustomMovementSubstepIndex = 0;
+		PhysCustomSubstep(DeltaTime, Iterations);
+		Super::PhysCustom(DeltaTime, Iterations);
+		return;
+	}
+
+	float SimulatedTime = FMath::Min(DeltaTime, MaxCustomMovementSubsteps * CustomMovementMaxStep);
+	INC_FLOAT_STAT_BY(STAT_CustomMovementDroppedTime, DeltaTime - SimulatedTime);
+
+	int32 SubstepsCount = FMath::Clamp(FMath::CeilToInt(SimulatedTime / CustomMovementMaxStep), 1, MaxCustomMovementSubsteps);
+	float SubstepTime = SimulatedTime / SubstepsCount;
+	uint8 SimulatedCustomMode = CustomMovementMode;
+
+	// Substeps depend only on the move's delta time, so the client and the server split the same move the same way
+	for (CustomMovementSubstepIndex = 0; CustomMovementSubstepIndex < SubstepsCount; ++CustomMovementSubstepIndex)
+	{
+		INC_DWORD_STAT(STAT_CustomMovementSubsteps);
+		PhysCustomSubstep(SubstepTime, Iterations + CustomMovementSubstepIndex);
+
+		// Detaching from a ladder or zipline switches the mode, the rest of the frame belongs to the new mode next frame
+		if (MovementMode != MOVE_Custom || CustomMovementMode != SimulatedCustomMode)
+		{
+			break;
+		}
+	}
+	CustomMovementSubstepIndex = 0;
+
+	Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void UGCBaseCharacterMovementComponent::PhysCustomSubstep(float DeltaTime, int32 Iterations)
 {
 	switch (CustomMovementMode)
 	{
@@ -441,7 +734,6 @@ void UGCBaseCharacterMovementComponent::PhysCustom(float DeltaTime, int32 Iterat
 	default:
 		break;
 	}
-	Super::PhysCustom(DeltaTime, Iterations);
 }
 
 void UGCBaseCharacterMovementComponent::PhysMantling(float DeltaTime, uint32 Iterations)
@@ -489,7 +781,7 @@ void UGCBaseCharacterMovementComponent::PhysLadder(float DeltaTime, uint32 Itera
 		DettachFromLadder(EDettachFromLadderMethod::ReachingTheBottom);
 		return;
 	}
-	else if (NewPosProjection > (CurrentLadder->GetLadderHeight() - MaxLadderTopOffset))
+	else if (NewPosProjection > (CurrentLadderSegment.Height - MaxLadderTopOffset))
 	{
 		DettachFromLadder(EDettachFromLadderMethod::ReachingTheTop);
 		return;
@@ -501,60 +793,105 @@ void UGCBaseCharacterMovementComponent::PhysLadder(float DeltaTime, uint32 Itera
 void UGCBaseCharacterMovementComponent::PhysZipline(float DeltaTime, uint32 Iterations)
 {
 	ZiplineAccelerationTimeline.TickTimeline(DeltaTime);
-	FVector Delta = ZiplineDirection * CurrentZiplineSpeed * DeltaTime;
+	FVector Delta = CurrentZiplineSegment.Direction * CurrentZiplineSpeed * DeltaTime;
 	
 	FHitResult Hit;
-	SafeMoveUpdatedComponent(Delta, GetOwner()->GetActorRotation(), true, Hit);
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+	CurrentZiplineSegment.TraveledDistance += Hit.bBlockingHit ? Hit.Time * Delta.Size() : Delta.Size();
 
-	if (Hit.Actor == CurrentZipline)
+	if (Hit.Actor == CurrentZipline || CurrentZiplineSegment.TraveledDistance >= CurrentZiplineSegment.Length)
 	{
 		DettachFromZipline();
 	}
-
-	UE_LOG(LogBaseCharacterMovement, Display, TEXT("Current Zipline Speed | %f"), CurrentZiplineSpeed);
 }
 
 void UGCBaseCharacterMovementComponent::PhysWallRun(float DeltaTime, uint32 Iterations)
-{		
-	FHitResult LineTraceHitResult;
-
-	FVector BaseCharacterRightVector = GetBaseCharacterOwner()->GetActorRightVector();
-	FVector LineTraceDirection = CurrentWallRunParameters.Side == EWallRunSide::Right ? BaseCharacterRightVector : -BaseCharacterRightVector;
-
-	FVector LineTraceStart = GetBaseCharacterOwner()->GetActorLocation();
-	FVector LineTraceEnd = LineTraceStart + WallRunUpdateLinetraceLength * LineTraceDirection;
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(GetBaseCharacterOwner());
+{
+	// Wall plane is shifted away from the wall by the trace length, so leaving the reach of the validation trace needs no query
+	FVector LineTraceStart = UpdatedComponent->GetComponentLocation();
+	if (CurrentWallRunParameters.WallPlane.PlaneDot(LineTraceStart) > 0.0f)
+	{
+		StopWallRun();
+		return;
+	}
 
-	if (GetWorld()->LineTraceSingleByChannel(LineTraceHitResult, LineTraceStart, LineTraceEnd, ECC_WallRunnable, QueryParams))
+	// The wall is validated by the first substep of a frame, later substeps rely on the plane test and their own move sweeps
+	if (CustomMovementSubstepIndex == 0)
 	{
-		EWallRunSide Side = EWallRunSide::None;
-		FVector Direction = FVector::ZeroVector;
-		GetWallRunSideAndDirection(LineTraceHitResult.ImpactNormal, Side, Direction);
+		FHitResult LineTraceHitResult;
+		FVector LineTraceEnd = LineTraceStart - WallRunUpdateLinetraceLength * CurrentWallRunParameters.WallNormal;
 
-		if (Side != CurrentWallRunParameters.Side)
+		if (!GetWorld()->LineTraceSingleByChannel(LineTraceHitResult, LineTraceStart, LineTraceEnd, ECC_WallRunnable, OwnerQueryParams)
+			|| FVector::DotProduct(LineTraceHitResult.ImpactNormal, CurrentWallRunParameters.WallNormal) <= 0.0f)
 		{
 			StopWallRun();
+			return;
 		}
-		else
+
+		if (!LineTraceHitResult.ImpactNormal.Equals(CurrentWallRunParameters.WallNormal))
 		{
-			CurrentWallRunParameters.Direction = Direction;
-			FVector Delta = CurrentWallRunParameters.Direction * CurrentWallRunParameters.Speed * DeltaTime;
-			FHitResult MoveHit;
-			SafeMoveUpdatedComponent(Delta, GetOwner()->GetActorRotation(), true, MoveHit);
+			CurrentWallRunParameters.WallNormal = LineTraceHitResult.ImpactNormal;
+			CurrentWallRunParameters.WallPlane = FPlane(LineTraceHitResult.ImpactPoint + WallRunUpdateLinetraceLength * LineTraceHitResult.ImpactNormal, LineTraceHitResult.ImpactNormal);
+			CurrentWallRunParameters.Direction = GetWallRunDirection(LineTraceHitResult.ImpactNormal, CurrentWallRunParameters.Side);
 		}
 	}
-	else
+
+	FVector Delta = CurrentWallRunParameters.Direction * CurrentWallRunParameters.Speed * DeltaTime;
+	FHitResult MoveHit;
+	SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, MoveHit);
+}
+
+static ETelemetryEventType GetTraversalTelemetryEventType(uint8 CustomMode, bool bIsStarted)
+{
+	switch (CustomMode)
 	{
-		StopWallRun();
+	case (uint8)ECustomMovementMode::CMOVE_Mantling:
+		return bIsStarted ? ETelemetryEventType::MantleStart : ETelemetryEventType::MantleEnd;
+	case (uint8)ECustomMovementMode::CMOVE_Ladder:
+		return bIsStarted ? ETelemetryEventType::LadderAttach : ETelemetryEventType::LadderDetach;
+	case (uint8)ECustomMovementMode::CMOVE_Zipline:
+		return bIsStarted ? ETelemetryEventType::ZiplineAttach : ETelemetryEventType::ZiplineDetach;
+	case (uint8)ECustomMovementMode::CMOVE_WallRun:
+		return bIsStarted ? ETelemetryEventType::WallRunStart : ETelemetryEventType::WallRunEnd;
+	default:
+		return ETelemetryEventType::Max;
 	}
-
 }
 
 void UGCBaseCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	const FMovementModePolicy& PreviousMovementModePolicy = *CurrentMovementModePolicy;
+	CurrentMovementModePolicy = &GCMovementState::GetMovementModePolicy(MovementMode, CustomMovementMode);
+	MovementState = (MovementState & ~EMovementState::MovementModes) | CurrentMovementModePolicy->State;
+
+	if (!CurrentMovementModePolicy->bMeshRotationAllowed)
+	{
+		GetBaseCharacterOwner()->DisableMeshRotation();
+	}
+	else if (!PreviousMovementModePolicy.bMeshRotationAllowed)
+	{
+		GetBaseCharacterOwner()->EnableMeshRotation();
+	}
+
+	if (PreviousMovementMode == MOVE_Custom)
+	{
+		ETelemetryEventType EventType = GetTraversalTelemetryEventType(PreviousCustomMode, false);
+		if (EventType != ETelemetryEventType::Max)
+		{
+			GCTelemetry::RecordEvent(EventType, CharacterOwner, nullptr, Velocity.Size(), UpdatedComponent->GetComponentLocation());
+		}
+	}
+	if (MovementMode == MOVE_Custom)
+	{
+		ETelemetryEventType EventType = GetTraversalTelemetryEventType(CustomMovementMode, true);
+		if (EventType != ETelemetryEventType::Max)
+		{
+			GCTelemetry::RecordEvent(EventType, CharacterOwner, nullptr, Velocity.Size(), UpdatedComponent->GetComponentLocation());
+		}
+	}
+
 	if (MovementMode == MOVE_Swimming)
 	{
 		CharacterOwner->GetCapsuleComponent()->SetCapsuleSize(SwimmingCapsuleRadius, SwimmingCapsuleHalfHeight);
@@ -567,19 +904,16 @@ void UGCBaseCharacterMovementComponent::OnMovementModeChanged(EMovementMode Prev
 
 	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)ECustomMovementMode::CMOVE_Ladder)
 	{
-		GetBaseCharacterOwner()->EnableMeshRotation();
 		CurrentLadder = nullptr;
 	}
 
 	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)ECustomMovementMode::CMOVE_Zipline)
 	{
-		GetBaseCharacterOwner()->EnableMeshRotation();
 		CurrentZipline = nullptr;
 	}
 
 	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == (uint8)ECustomMovementMode::CMOVE_WallRun)
 	{
-		GetBaseCharacterOwner()->EnableMeshRotation();
 		GetWorld()->GetTimerManager().ClearTimer(WallRunTimer);
 	}
 
@@ -594,28 +928,22 @@ void UGCBaseCharacterMovementComponent::OnMovementModeChanged(EMovementMode Prev
 			}
 			case (uint8)ECustomMovementMode::CMOVE_WallRun:
 			{
-				GetBaseCharacterOwner()->DisableMeshRotation();
 				FTimerDelegate WallRunTimerDel;
 				WallRunTimerDel.BindUObject(this, &UGCBaseCharacterMovementComponent::StopWallRun, EStopWallRunMethod::Fall);
 				GetWorld()->GetTimerManager().SetTimer(WallRunTimer, WallRunTimerDel, MaxWallRunTime, false);
 				break;
 			}
-		case (uint8)ECustomMovementMode::CMOVE_Ladder:
-			{
-				GetBaseCharacterOwner()->DisableMeshRotation();
-				break;
-			}
-		case (uint8)ECustomMovementMode::CMOVE_Zipline:
-			{
-				GetBaseCharacterOwner()->DisableMeshRotation();
-				break;
-			}
 		default:
 			break;
 		}
 	}
 }
 
+void UGCBaseCharacterMovementComponent::SetMovementState(EMovementState States, bool bIsSet)
+{
+	MovementState = bIsSet ? MovementState | States : MovementState & ~States;
+}
+
 AGCBaseCharacter* UGCBaseCharacterMovementComponent::GetBaseCharacterOwner() const
 {
 	return StaticCast<AGCBaseCharacter*>(CharacterOwner);
@@ -634,14 +962,15 @@ bool UGCBaseCharacterMovementComponent::IsSurfaceWallRunable(const FVector& Surf
 
 void UGCBaseCharacterMovementComponent::GetWallRunSideAndDirection(const FVector& HitNormal, EWallRunSide& OutSide, FVector& OutDirection) const
 {
-	if (FVector::DotProduct(HitNormal, GetBaseCharacterOwner()->GetActorRightVector()) > 0.f)
-	{
-		OutSide = EWallRunSide::Left;
-		OutDirection = FVector::CrossProduct(HitNormal, FVector::UpVector).GetSafeNormal();
-	}
-	else
+	OutSide = FVector::DotProduct(HitNormal, GetBaseCharacterOwner()->GetActorRightVector()) > 0.f ? EWallRunSide::Left : EWallRunSide::Right;
+	OutDirection = GetWallRunDirection(HitNormal, OutSide);
+}
+
+FVector UGCBaseCharacterMovementComponent::GetWallRunDirection(const FVector& WallNormal, EWallRunSide Side) const
+{
+	if (Side == EWallRunSide::Left)
 	{
-		OutSide = EWallRunSide::Right;
-		OutDirection = FVector::CrossProduct(FVector::UpVector, HitNormal).GetSafeNormal();
+		return FVector::CrossProduct(WallNormal, FVector::UpVector).GetSafeNormal();
 	}
+	return FVector::CrossProduct(FVector::UpVector, WallNormal).GetSafeNormal();
 }
\ No newline at end of file
@@ -13,6 +13,8 @@
 #include "Characters/GCBaseCharacter.h"
 #include "GCBaseCharacterMovementComponent.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSprintStateChangedSignature, bool);
+
 /**
  * 
  */
@@ -53,6 +55,170 @@ enum class EStopWallRunMethod : uint8
 	JumpOff
 };
 
+/**
+ * Movement mode bits are rebuilt in OnMovementModeChanged, the rest are set where the state itself changes
+ */
+enum class EMovementState : uint32
+{
+	None = 0,
+	Walking = 1 << 0,
+	Falling = 1 << 1,
+	Swimming = 1 << 2,
+	Flying = 1 << 3,
+	Mantling = 1 << 4,
+	Ladder = 1 << 5,
+	Zipline = 1 << 6,
+	WallRun = 1 << 7,
+	Crouching = 1 << 8,
+	Sprinting = 1 << 9,
+	Sliding = 1 << 10,
+	OutOfStamina = 1 << 11,
+	Aiming = 1 << 12,
+
+	MovementModes = Walking | Falling | Swimming | Flying | Mantling | Ladder | Zipline | WallRun
+};
+ENUM_CLASS_FLAGS(EMovementState)
+
+enum class EMovementSpeedPolicy : uint8
+{
+	// Max speed of the movement mode itself
+	Unmodified = 0,
+	// Aiming, out of stamina and sprint speeds override the max speed of the movement mode
+	Ground,
+	Ladder,
+	WallRun
+};
+
+struct FMovementModePolicy
+{
+	EMovementState State;
+	EMovementSpeedPolicy SpeedPolicy;
+	bool bMeshRotationAllowed;
+	bool bJumpAllowed;
+	bool bFireAllowed;
+	bool bSprintAllowed;
+	bool bMantleAllowed;
+	bool bWallRunAllowed;
+};
+
+/**
+ * Specialize for a new custom movement mode and add it to CustomMovementModePolicies, movement state checks pick it up from there
+ */
+template<ECustomMovementMode Mode>
+struct TCustomMovementModeTraits
+{
+	static constexpr EMovementState State = EMovementState::None;
+	static constexpr EMovementSpeedPolicy SpeedPolicy = EMovementSpeedPolicy::Ground;
+	static constexpr bool bMeshRotationAllowed = true;
+	static constexpr bool bJumpAllowed = true;
+	static constexpr bool bFireAllowed = true;
+	static constexpr bool bSprintAllowed = true;
+	static constexpr bool bMantleAllowed = true;
+	static constexpr bool bWallRunAllowed = true;
+};
+
+template<>
+struct TCustomMovementModeTraits<ECustomMovementMode::CMOVE_Mantling> : TCustomMovementModeTraits<ECustomMovementMode::CMOVE_None>
+{
+	static constexpr EMovementState State = EMovementState::Mantling;
+	static constexpr bool bJumpAllowed = false;
+	static constexpr bool bFireAllowed = false;
+	static constexpr bool bSprintAllowed = false;
+	static constexpr bool bMantleAllowed = false;
+	static constexpr bool bWallRunAllowed = false;
+};
+
+template<>
+struct TCustomMovementModeTraits<ECustomMovementMode::CMOVE_Ladder> : TCustomMovementModeTraits<ECustomMovementMode::CMOVE_None>
+{
+	static constexpr EMovementState State = EMovementState::Ladder;
+	static constexpr EMovementSpeedPolicy SpeedPolicy = EMovementSpeedPolicy::Ladder;
+	static constexpr bool bMeshRotationAllowed = false;
+	static constexpr bool bFireAllowed = false;
+	static constexpr bool bMantleAllowed = false;
+	static constexpr bool bWallRunAllowed = false;
+};
+
+template<>
+struct TCustomMovementModeTraits<ECustomMovementMode::CMOVE_Zipline> : TCustomMovementModeTraits<ECustomMovementMode::CMOVE_None>
+{
+	static constexpr EMovementState State = EMovementState::Zipline;
+	static constexpr bool bMeshRotationAllowed = false;
+	static constexpr bool bJumpAllowed = false;
+	static constexpr bool bFireAllowed = false;
+	static constexpr bool bMantleAllowed = false;
+	static constexpr bool bWallRunAllowed = false;
+};
+
+template<>
+struct TCustomMovementModeTraits<ECustomMovementMode::CMOVE_WallRun> : TCustomMovementModeTraits<ECustomMovementMode::CMOVE_None>
+{
+	static constexpr EMovementState State = EMovementState::WallRun;
+	static constexpr EMovementSpeedPolicy SpeedPolicy = EMovementSpeedPolicy::WallRun;
+	static constexpr bool bMeshRotationAllowed = false;
+	static constexpr bool bSprintAllowed = false;
+};
+
+namespace GCMovementState
+{
+	template<ECustomMovementMode Mode>
+	constexpr FMovementModePolicy MakeCustomMovementModePolicy()
+	{
+		using FTraits = TCustomMovementModeTraits<Mode>;
+		return { FTraits::State, FTraits::SpeedPolicy, FTraits::bMeshRotationAllowed, FTraits::bJumpAllowed, FTraits::bFireAllowed, FTraits::bSprintAllowed, FTraits::bMantleAllowed, FTraits::bWallRunAllowed };
+	}
+
+	// State, speed policy, then mesh rotation, jump, fire, sprint, mantle and wall run permissions
+	constexpr FMovementModePolicy MovementModePolicies[] =
+	{
+		/* MOVE_None */			{ EMovementState::None, EMovementSpeedPolicy::Ground, true, true, true, true, true, true },
+		/* MOVE_Walking */		{ EMovementState::Walking, EMovementSpeedPolicy::Ground, true, true, true, true, true, true },
+		/* MOVE_NavWalking */	{ EMovementState::Walking, EMovementSpeedPolicy::Ground, true, true, true, true, true, true },
+		/* MOVE_Falling */		{ EMovementState::Falling, EMovementSpeedPolicy::Unmodified, true, true, false, false, false, true },
+		/* MOVE_Swimming */		{ EMovementState::Swimming, EMovementSpeedPolicy::Ground, true, true, false, true, true, false },
+		/* MOVE_Flying */		{ EMovementState::Flying, EMovementSpeedPolicy::Ground, true, true, true, true, true, true }
+	};
+	static_assert(UE_ARRAY_COUNT(MovementModePolicies) == (uint8)MOVE_Custom, "Every engine movement mode but MOVE_Custom needs a policy");
+
+	constexpr FMovementModePolicy CustomMovementModePolicies[] =
+	{
+		MakeCustomMovementModePolicy<ECustomMovementMode::CMOVE_None>(),
+		MakeCustomMovementModePolicy<ECustomMovementMode::CMOVE_Mantling>(),
+		MakeCustomMovementModePolicy<ECustomMovementMode::CMOVE_Ladder>(),
+		MakeCustomMovementModePolicy<ECustomMovementMode::CMOVE_Zipline>(),
+		MakeCustomMovementModePolicy<ECustomMovementMode::CMOVE_WallRun>()
+	};
+	static_assert(UE_ARRAY_COUNT(CustomMovementModePolicies) == (uint8)ECustomMovementMode::CMOVE_MAX, "Every custom movement mode needs a policy");
+
+	constexpr const FMovementModePolicy& GetMovementModePolicy(EMovementMode Mode, uint8 CustomMode)
+	{
+		return Mode == MOVE_Custom
+			? CustomMovementModePolicies[CustomMode < (uint8)ECustomMovementMode::CMOVE_MAX ? CustomMode : 0]
+			: MovementModePolicies[Mode < MOVE_Custom ? Mode : 0];
+	}
+
+	// States of every movement mode, which policy doesn't have the permission
+	constexpr EMovementState GetModesWithout(bool FMovementModePolicy::* Permission)
+	{
+		EMovementState Result = EMovementState::None;
+		for (const FMovementModePolicy& Policy : MovementModePolicies)
+		{
+			Result = Policy.*Permission ? Result : Result | Policy.State;
+		}
+		for (const FMovementModePolicy& Policy : CustomMovementModePolicies)
+		{
+			Result = Policy.*Permission ? Result : Result | Policy.State;
+		}
+		return Result;
+	}
+
+	constexpr EMovementState JumpBlockers = GetModesWithout(&FMovementModePolicy::bJumpAllowed);
+	constexpr EMovementState FireBlockers = GetModesWithout(&FMovementModePolicy::bFireAllowed) | EMovementState::OutOfStamina | EMovementState::Sliding;
+	constexpr EMovementState SprintBlockers = GetModesWithout(&FMovementModePolicy::bSprintAllowed) | EMovementState::OutOfStamina | EMovementState::Sliding | EMovementState::Crouching;
+	constexpr EMovementState MantleBlockers = GetModesWithout(&FMovementModePolicy::bMantleAllowed) | EMovementState::OutOfStamina | EMovementState::Sliding;
+	constexpr EMovementState WallRunBlockers = GetModesWithout(&FMovementModePolicy::bWallRunAllowed) | EMovementState::OutOfStamina;
+}
+
 struct FMantlingMovementParameters
 {
 	FVector InitialLocation = FVector::ZeroVector;
@@ -76,29 +242,119 @@ struct FWallRunParameters
 	EWallRunSide Side = EWallRunSide::None;
 	FVector Direction = FVector::ZeroVector;
 	FVector WallNormal = FVector::ZeroVector;
+	FPlane WallPlane = FPlane(ForceInitToZero);
 	float Speed = 0.0f;
 };
 
+/**
+ * Traversal segments are captured once on attach, so per tick updates don't have to read actor transforms
+ */
+struct FLadderSegment
+{
+	FVector Origin = FVector::ZeroVector;
+	FVector UpVector = FVector::UpVector;
+	FVector ForwardVector = FVector::ForwardVector;
+	float Height = 0.0f;
+};
+
+struct FZiplineSegment
+{
+	FVector Start = FVector::ZeroVector;
+	FVector Direction = FVector::ZeroVector;
+	float Length = 0.0f;
+	float TraveledDistance = 0.0f;
+};
+
+/**
+ * Sprint and slide travel as compressed flags, ladder and zipline travel as the id of the interactive actor in the move data.
+ * Mantle and wall run aren't part of the move data, the server corrects a client entering them on its own
+ */
+class FSavedMove_GC : public FSavedMove_Character
+{
+	typedef FSavedMove_Character Super;
+
+public:
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* InCharacter, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* InCharacter) override;
+
+	uint32 SavedTraversalActorId = 0;
+	uint8 bSavedIsSprinting : 1;
+	uint8 bSavedIsSliding : 1;
+};
+
+class FNetworkPredictionData_Client_GC : public FNetworkPredictionData_Client_Character
+{
+	typedef FNetworkPredictionData_Client_Character Super;
+
+public:
+	FNetworkPredictionData_Client_GC(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+struct FGCCharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+	typedef FCharacterNetworkMoveData Super;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+
+	uint32 TraversalActorId = 0;
+};
+
+struct FGCCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FGCCharacterNetworkMoveDataContainer();
+
+	FGCCharacterNetworkMoveData GCMoveData[3];
+};
+
 UCLASS()
 class GAMECODE_API UGCBaseCharacterMovementComponent : public UCharacterMovementComponent
 {
 	GENERATED_BODY()
 	
 public:
+	UGCBaseCharacterMovementComponent();
+
 	virtual void PhysicsRotation(float DeltaTime) override;
 
-	bool IsSprinting() const { return bIsSprinting; }
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+
+	// Id of the ladder or zipline the character is attached to, 0 otherwise
+	uint32 GetTraversalActorId() const;
 
-	bool IsSliding() const { return bIsSliding; }
+	const FCollisionQueryParams& GetOwnerQueryParams() const { return OwnerQueryParams; }
 
-	bool IsOutOfStamina() const { return bIsOutOfStamina; }
+	EMovementState GetMovementState() const { return MovementState; }
+	bool HasAnyMovementState(EMovementState States) const { return EnumHasAnyFlags(MovementState, States); }
+	const FMovementModePolicy& GetMovementModePolicy() const { return *CurrentMovementModePolicy; }
+
+	bool IsSprinting() const { return HasAnyMovementState(EMovementState::Sprinting); }
+
+	bool IsSliding() const { return HasAnyMovementState(EMovementState::Sliding); }
+
+	bool IsOutOfStamina() const { return HasAnyMovementState(EMovementState::OutOfStamina); }
 	void SetIsOutOfStamina(bool bIsOutOfStamina_In);
 
+	// Aiming speed is a part of the max speed, the character keeps the state here to not be asked for it every move
+	void SetIsAiming(bool bIsAiming);
+
 	virtual float GetMaxSpeed() const override;
 
+	virtual void Crouch(bool bClientSimulation = false) override;
+	virtual void UnCrouch(bool bClientSimulation = false) override;
+
 	void StartSprint();
 	void StopSprint();
 
+	FOnSprintStateChangedSignature OnSprintStateChanged;
+
 	void StartSlide(FSlideSettings SlideSettings);
 	void UpdateSlide(float DeltaTime, FSlideSettings SlideSettings);
 	void UpdateSlideSpeed(float Alpha);
@@ -106,23 +362,24 @@ public:
 
 	void StartMantle(const FMantlingMovementParameters& MantlingParameters);
 	void EndMantle();
-	bool IsMantling() const;
+	bool IsMantling() const { return HasAnyMovementState(EMovementState::Mantling); }
 
 	void AttachToLadder(const ALadder* Ladder);
 	float GetActorToCurrentLadderProjection(const FVector& Location) const;
 	void DettachFromLadder(EDettachFromLadderMethod DettachFromLadderMethod = EDettachFromLadderMethod::Fall);
-	bool IsOnLadder() const;
+	bool IsOnLadder() const { return HasAnyMovementState(EMovementState::Ladder); }
 	const class ALadder* GetCurrentLadder();
+	const FLadderSegment& GetCurrentLadderSegment() const { return CurrentLadderSegment; }
 	float GetLadderSpeedRatio() const;
 
 	void AttachToZipline(const AZipline* Zipline);
 	void DettachFromZipline();
-	bool IsOnZipline() const;
+	bool IsOnZipline() const { return HasAnyMovementState(EMovementState::Zipline); }
 	const class AZipline* GetCurrentZipline();
 
 	void StartWallRun(const FVector& HitNormal);
 	void StopWallRun(EStopWallRunMethod StopWallRunMethod = EStopWallRunMethod::Fall);
-	bool IsWallRunning() const;
+	bool IsWallRunning() const { return HasAnyMovementState(EMovementState::WallRun); }
 	
 	FWallRunParameters GetWallRunParameters() const;
 
@@ -131,6 +388,7 @@ public:
 protected:
 	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
 
+	void PhysCustomSubstep(float DeltaTime, int32 Iterations);
 	void PhysMantling(float DeltaTime, uint32 Iterations);
 	void PhysLadder(float DeltaTime, uint32 Iterations);
 	void PhysZipline(float DeltaTime, uint32 Iterations);
@@ -203,24 +461,35 @@ protected:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Slide", meta = (ClampMin = 0.0f, UIMin = 0.0f))
 	float SlideDownLineTraceLength = 10.0f;
+
+	// Ladder, zipline and wall run are simulated in equal substeps no longer than CustomMovementMaxStep
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Custom substepping")
+	bool bUseCustomMovementSubstepping = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Custom substepping", meta = (ClampMin = 0.001f, UIMin = 0.001f, EditCondition = "bUseCustomMovementSubstepping"))
+	float CustomMovementMaxStep = 1.0f / 60.0f;
+
+	// Frame time beyond MaxCustomMovementSubsteps * CustomMovementMaxStep is not simulated, so hitches slow the character down instead of overshooting
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: Custom substepping", meta = (ClampMin = 1, UIMin = 1, EditCondition = "bUseCustomMovementSubstepping"))
+	int32 MaxCustomMovementSubsteps = 4;
 	
 	class AGCBaseCharacter* GetBaseCharacterOwner() const;
 
 private:
-	bool bIsSprinting;
-	bool bIsOutOfStamina;
-
-	bool bIsSliding;
+	EMovementState MovementState = EMovementState::None;
+	const FMovementModePolicy* CurrentMovementModePolicy = &GCMovementState::MovementModePolicies[MOVE_None];
+	void SetMovementState(EMovementState States, bool bIsSet);
 
 	FMantlingMovementParameters CurrentMantlingParameters;
 	FTimerHandle MantlingTimer;
 
 	const ALadder* CurrentLadder = nullptr;
+	FLadderSegment CurrentLadderSegment;
 	FRotator ForceTargetRotation = FRotator::ZeroRotator;
 	bool bForceRotation = false;
 
-	FVector ZiplineDirection = FVector::ZeroVector;
 	const AZipline* CurrentZipline = nullptr;
+	FZiplineSegment CurrentZiplineSegment;
 	FTimeline ZiplineAccelerationTimeline;
 	void ZiplineTimelineUpdate(float Alpha);
 	float InitialZiplineSpeed = 0.0f;
@@ -228,10 +497,19 @@ private:
 
 	bool IsSurfaceWallRunable(const FVector& SurfaceNormal) const;
 	void GetWallRunSideAndDirection(const FVector& HitNormal, EWallRunSide& OutSide, FVector& OutDirection) const;
+	FVector GetWallRunDirection(const FVector& WallNormal, EWallRunSide Side) const;
 	FWallRunParameters CurrentWallRunParameters;
 	FTimerHandle WallRunTimer;
 
 	FTimerHandle SlidingTimer;
 	FTimeline SlideSlowDownTimeline;
+
+	FCollisionQueryParams OwnerQueryParams;
+
+	FGCCharacterNetworkMoveDataContainer GCNetworkMoveDataContainer;
+
+	void ApplyClientTraversal(uint32 TraversalActorId, uint8 PackedMovementMode);
+
+	int32 CustomMovementSubstepIndex = 0;
 	float CurrentSlideSpeed = SlideMaxSpeed;
 };
@@ -3,6 +3,15 @@
 
 #include "GCBasePawnMovementComponent.h"
 
+void UGCBasePawnMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	float SphereRadius = 50.0f;
+	GroundCheckShape = FCollisionShape::MakeSphere(SphereRadius);
+	GroundCheckQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT_NAME_ONLY(GCPawnGroundCheck), false, GetOwner());
+}
+
 void UGCBasePawnMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	if (ShouldSkipUpdate(DeltaTime))
@@ -21,14 +30,10 @@ void UGCBasePawnMovementComponent::TickComponent(float DeltaTime, enum ELevelTic
 		FHitResult HitResult;
 		FVector StartPoint = UpdatedComponent->GetComponentLocation();
 		float TraceDepth = 1.0f;
-		float SphereRadius = 50.0f;
 		FVector EndPoint = StartPoint - TraceDepth * FVector::UpVector;
-		FCollisionQueryParams CollisionParams;
-		CollisionParams.AddIgnoredActor(GetOwner());
 
 		bool bWasFalling = bIsFalling;
-		FCollisionShape Sphere = FCollisionShape::MakeSphere(SphereRadius);
-		bIsFalling = !GetWorld()->SweepSingleByChannel(HitResult, StartPoint, EndPoint, FQuat::Identity, ECC_Visibility, Sphere, CollisionParams);
+		bIsFalling = !GetWorld()->SweepSingleByChannel(HitResult, StartPoint, EndPoint, FQuat::Identity, ECC_Visibility, GroundCheckShape, GroundCheckQueryParams);
 		if (bIsFalling)
 		{
 			VerticalVelocity += GetGravityZ() * FVector::UpVector * DeltaTime;
@@ -22,6 +22,8 @@ public:
 	virtual bool IsFalling() const override;
 
 protected:
+	virtual void BeginPlay() override;
+
 	UPROPERTY(EditAnywhere)
 	float MaxSpeed = 1200.0f;
 
@@ -34,4 +36,7 @@ protected:
 private:
 	FVector VerticalVelocity = FVector::ZeroVector;	
 	bool bIsFalling = false;
+
+	FCollisionShape GroundCheckShape;
+	FCollisionQueryParams GroundCheckQueryParams;
 };
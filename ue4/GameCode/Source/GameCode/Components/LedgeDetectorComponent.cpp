@@ -4,6 +4,7 @@
 #include "LedgeDetectorComponent.h"
 #include "../GameCodeTypes.h"
 #include <GameFramework/Character.h>
+#include <GameFramework/CharacterMovementComponent.h>
 #include <Components/CapsuleComponent.h>
 #include "DrawDebugHelpers.h"
 #include "../Utils/GCTraceUtils.h"
@@ -11,62 +12,131 @@
 #include <Kismet/GameplayStatics.h>
 #include "../Subsystems/DebugSubsystem.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ledge cache hits"), STAT_LedgeCacheHits, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ledge cache misses"), STAT_LedgeCacheMisses, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ledge queries saved"), STAT_LedgeQueriesSaved, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ledge background scans"), STAT_LedgeScans, STATGROUP_GameCode);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Ledge cache hit rate"), STAT_LedgeCacheHitRate, STATGROUP_GameCode);
+
+// Hit rate of the current frame, counts start over on the first request of every frame
+static void UpdateLedgeCacheHitRate(bool bIsHit)
+{
+	static uint64 CountedFrame = 0;
+	static int32 RequestsCount = 0;
+	static int32 HitsCount = 0;
+	if (CountedFrame != GFrameCounter)
+	{
+		CountedFrame = GFrameCounter;
+		RequestsCount = 0;
+		HitsCount = 0;
+	}
+
+	++RequestsCount;
+	HitsCount += bIsHit ? 1 : 0;
+	SET_FLOAT_STAT(STAT_LedgeCacheHitRate, (float)HitsCount / RequestsCount);
+}
+
+ULedgeDetectorComponent::ULedgeDetectorComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// AI and simulated proxies never scan, the tick is enabled once the owner turns out to be the local player
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
 // Called when the game starts
 void ULedgeDetectorComponent::BeginPlay()
 {
 	Super::BeginPlay();
 	checkf(GetOwner()->IsA<ACharacter>(), TEXT("ULedgeDetectorComponent::BeginPlay() only a Character can use ULedgeDetectorComponent"))
 	CachedCharacterOwner = StaticCast<ACharacter*>(GetOwner());
-}
-
-bool ULedgeDetectorComponent::DetectLedge(OUT FLedgeDescription& LedgeDescription)
-{
-	UCapsuleComponent* CapsuleComponent = CachedCharacterOwner->GetCapsuleComponent();
+	LedgeQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT_NAME_ONLY(LedgeDetection), true, GetOwner());
 
 	ACharacter* DefaultCharacter = CachedCharacterOwner->GetClass()->GetDefaultObject<ACharacter>();
-	float DefaultCapsuleHalfHeight = DefaultCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
-	float DefaultCapsuleRadius = DefaultCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	DefaultCapsuleHalfHeight = DefaultCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	OnOwnerControllerChanged();
+}
 
-	FCollisionQueryParams QueryParams;
-	QueryParams.bTraceComplex = true;
-	QueryParams.AddIgnoredActor(GetOwner());
+void ULedgeDetectorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (ShouldScan())
+	{
+		Scan();
+	}
+}
 
-	float BottomZOffset = 2.0f;
-	FVector CharacterBottom = CachedCharacterOwner->GetActorLocation() - (CapsuleComponent->GetScaledCapsuleHalfHeight() - BottomZOffset) * FVector::UpVector;
+void ULedgeDetectorComponent::OnOwnerControllerChanged()
+{
+	bool bIsLocalPlayer = CachedCharacterOwner.IsValid() && CachedCharacterOwner->IsLocallyControlled() && CachedCharacterOwner->IsPlayerControlled();
+	SetComponentTickEnabled(bIsLocalPlayer);
+}
 
+bool ULedgeDetectorComponent::DetectLedge(OUT FLedgeDescription& LedgeDescription)
+{
 	//Debug settings
 #if ENABLE_DRAW_DEBUG
 	UDebugSubsystem* DebugSubsystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UDebugSubsystem>();
 	bool bIsDebugEnabled = DebugSubsystem->IsCategoryEnabled(DebugCategoryLedgeDetection);
 #else
-	bIsDebugEnabled = false;
+	bool bIsDebugEnabled = false;
 #endif
 
+	bool bHasLedge = false;
+	if (TryGetScannedLedge(LedgeDescription, bHasLedge, bIsDebugEnabled))
+	{
+		INC_DWORD_STAT(STAT_LedgeCacheHits);
+		// A cached ledge still costs the validation overlap, a cached miss costs nothing but could have ended after the first sweep
+		INC_DWORD_STAT_BY(STAT_LedgeQueriesSaved, bHasLedge ? 2 : 1);
+		UpdateLedgeCacheHitRate(true);
+		return bHasLedge;
+	}
+
+	INC_DWORD_STAT(STAT_LedgeCacheMisses);
+	UpdateLedgeCacheHitRate(false);
+
+	bHasLedge = DetectLedgeUncached(LedgeDescription, bIsDebugEnabled);
+	LastScan.LedgeDescription = LedgeDescription;
+	LastScan.ScanLocation = CachedCharacterOwner->GetActorLocation();
+	LastScan.ScanForward = CachedCharacterOwner->GetActorForwardVector();
+	LastScan.ScanTime = GetWorld()->GetTimeSeconds();
+	LastScan.bHasLedge = bHasLedge;
+	return bHasLedge;
+}
+
+bool ULedgeDetectorComponent::DetectLedgeUncached(OUT FLedgeDescription& LedgeDescription, bool bIsDebugEnabled) const
+{
+	UCapsuleComponent* CapsuleComponent = CachedCharacterOwner->GetCapsuleComponent();
+
+	float BottomZOffset = 2.0f;
+	FVector CharacterBottom = CachedCharacterOwner->GetActorLocation() - (CapsuleComponent->GetScaledCapsuleHalfHeight() - BottomZOffset) * FVector::UpVector;
+
 	float DrawTime = 2.0f;
 		
 	//1. Forward check
 	float ForwardCheckCapsuleRadius = CapsuleComponent->GetScaledCapsuleRadius();
 	float ForwardCheckCapsuleHalfHeight = (MaxLedgeHeight - MinLedgeHeight) * 0.5f;
+	FCollisionShape ForwardCheckShape = FCollisionShape::MakeCapsule(ForwardCheckCapsuleRadius, ForwardCheckCapsuleHalfHeight);
 
 	FHitResult ForwardCheckHitResult;
 	FVector ForwardTraceStartLocation = CharacterBottom + (MinLedgeHeight + ForwardCheckCapsuleHalfHeight) * FVector::UpVector;
 	FVector ForwardTraceEndLocation = ForwardTraceStartLocation + CachedCharacterOwner->GetActorForwardVector() * ForwardCheckDistance;
 
 
-	if (!GCTraceUtils::SweepCapsuleSingleByChannel(GetWorld(), ForwardCheckHitResult, ForwardTraceStartLocation, ForwardTraceEndLocation, ForwardCheckCapsuleRadius, ForwardCheckCapsuleHalfHeight, FQuat::Identity, ECC_Climbing, QueryParams, FCollisionResponseParams::DefaultResponseParam, bIsDebugEnabled, DrawTime))
+	if (!GCTraceUtils::SweepCapsuleSingleByChannel(GetWorld(), ForwardCheckHitResult, ForwardTraceStartLocation, ForwardTraceEndLocation, ForwardCheckShape, FQuat::Identity, ECC_Climbing, LedgeQueryParams, FCollisionResponseParams::DefaultResponseParam, bIsDebugEnabled, DrawTime))
 	{
 		return false;
 	}
 
 	//2. Downward check
 	float DownwardCheckSphereRadius = CapsuleComponent->GetScaledCapsuleRadius();
+	FCollisionShape DownwardCheckShape = FCollisionShape::MakeSphere(DownwardCheckSphereRadius);
 	float DownwardCheckDepthOffset = 10.0f;
 	FHitResult DownwardCheckHitResult;
 	FVector DownwardTraceStartLocation = ForwardCheckHitResult.ImpactPoint - ForwardCheckHitResult.ImpactNormal * DownwardCheckDepthOffset;
 	DownwardTraceStartLocation.Z = CharacterBottom.Z + MaxLedgeHeight + DownwardCheckSphereRadius;
 	FVector DownwardTraceEndLocation(DownwardTraceStartLocation.X, DownwardTraceStartLocation.Y, CharacterBottom.Z);
 
-	if(!GCTraceUtils::SweepSphereSingleByChannel(GetWorld(), DownwardCheckHitResult, DownwardTraceStartLocation, DownwardTraceEndLocation, DownwardCheckSphereRadius, ECC_Climbing, QueryParams, FCollisionResponseParams::DefaultResponseParam, bIsDebugEnabled, DrawTime))
+	if(!GCTraceUtils::SweepSphereSingleByChannel(GetWorld(), DownwardCheckHitResult, DownwardTraceStartLocation, DownwardTraceEndLocation, DownwardCheckShape, ECC_Climbing, LedgeQueryParams, FCollisionResponseParams::DefaultResponseParam, bIsDebugEnabled, DrawTime))
 	{
 		return false;
 	}
@@ -77,7 +147,7 @@ bool ULedgeDetectorComponent::DetectLedge(OUT FLedgeDescription& LedgeDescriptio
 	float OverlapCapsuleFloorOffset = 2.0f;
 	FVector OverlapLocation = DownwardCheckHitResult.ImpactPoint + (DefaultCapsuleHalfHeight + OverlapCapsuleFloorOffset) * FVector::UpVector;
 
-	if (GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, OverlapCapsuleRadius, OverlapCapsuleHalfHeight, FQuat::Identity, CollisionProfilePawn, QueryParams, bIsDebugEnabled, DrawTime))
+	if (GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, OverlapCapsuleRadius, OverlapCapsuleHalfHeight, FQuat::Identity, CollisionProfilePawn, LedgeQueryParams, bIsDebugEnabled, DrawTime))
 	{
 		return false;
 	}
@@ -89,4 +159,110 @@ bool ULedgeDetectorComponent::DetectLedge(OUT FLedgeDescription& LedgeDescriptio
 	LedgeDescription.LedgePrimitiveComponent = DownwardCheckHitResult.GetComponent();
 
 	return true;
+}
+
+bool ULedgeDetectorComponent::TryGetScannedLedge(OUT FLedgeDescription& LedgeDescription, OUT bool& bHasLedge, bool bIsDebugEnabled) const
+{
+	if (LastScan.ScanTime < 0.0f || GetWorld()->GetTimeSeconds() - LastScan.ScanTime > MaxScanAge)
+	{
+		return false;
+	}
+
+	if (FVector::DotProduct(CachedCharacterOwner->GetActorForwardVector(), LastScan.ScanForward) < FMath::Cos(FMath::DegreesToRadians(MaxScanAngleDeviation)))
+	{
+		return false;
+	}
+
+	FVector Location = CachedCharacterOwner->GetActorLocation();
+	FVector Delta = Location - LastScan.ScanLocation;
+	if (!LastScan.bHasLedge)
+	{
+		// Any step forward may bring a ledge into reach, so a scan without a ledge only answers for the same spot
+		float NoLedgeLocationTolerance = 5.0f;
+		bHasLedge = false;
+		return Delta.SizeSquared() <= FMath::Square(NoLedgeLocationTolerance);
+	}
+
+	// Location is relative to the ledge primitive, reusing it on moving geometry would need the primitive's movement since the scan
+	UPrimitiveComponent* LedgePrimitive = LastScan.LedgeDescription.LedgePrimitiveComponent.Get();
+	if (!IsValid(LedgePrimitive) || LedgePrimitive->Mobility != EComponentMobility::Static)
+	{
+		return false;
+	}
+
+	UCapsuleComponent* CapsuleComponent = CachedCharacterOwner->GetCapsuleComponent();
+	float CapsuleRadius = CapsuleComponent->GetScaledCapsuleRadius();
+	float CapsuleHalfHeight = CapsuleComponent->GetScaledCapsuleHalfHeight();
+
+	float LedgeHeight = LastScan.LedgeDescription.LedgeImpactLocation.Z - (Location.Z - CapsuleHalfHeight);
+	if (LedgeHeight < MinLedgeHeight || LedgeHeight > MaxLedgeHeight)
+	{
+		return false;
+	}
+
+	FVector WallNormal = FVector(LastScan.LedgeDescription.LedgeNormal.X, LastScan.LedgeDescription.LedgeNormal.Y, 0.0f).GetSafeNormal();
+	float DistanceToLedge = FVector::DotProduct(LastScan.LedgeDescription.LedgeImpactLocation - Location, -WallNormal);
+	if (DistanceToLedge > ForwardCheckDistance + CapsuleRadius)
+	{
+		return false;
+	}
+
+	FVector LateralDelta = FVector::VectorPlaneProject(FVector(Delta.X, Delta.Y, 0.0f), WallNormal);
+	if (LateralDelta.SizeSquared() > FMath::Square(MaxLateralOffset))
+	{
+		return false;
+	}
+
+	float DrawTime = 2.0f;
+	FVector OverlapLocation = LastScan.LedgeDescription.Location + LedgePrimitive->GetComponentLocation() + LateralDelta;
+	if (GCTraceUtils::OverlapCapsuleBlockingByProfile(GetWorld(), OverlapLocation, CapsuleRadius, CapsuleHalfHeight, FQuat::Identity, CollisionProfilePawn, LedgeQueryParams, bIsDebugEnabled, DrawTime))
+	{
+		return false;
+	}
+
+	LedgeDescription = LastScan.LedgeDescription;
+	LedgeDescription.Location += LateralDelta;
+	LedgeDescription.LedgeImpactLocation += LateralDelta;
+	bHasLedge = true;
+	return true;
+}
+
+bool ULedgeDetectorComponent::ShouldScan() const
+{
+	// Mantling is started by the player input or by reaching a ladder top, other characters never ask for a ledge in advance
+	if (!CachedCharacterOwner.IsValid() || !CachedCharacterOwner->IsLocallyControlled() || !CachedCharacterOwner->IsPlayerControlled())
+	{
+		return false;
+	}
+
+	UCharacterMovementComponent* CharacterMovement = CachedCharacterOwner->GetCharacterMovement();
+	if (!CharacterMovement->IsMovingOnGround() && CharacterMovement->MovementMode != MOVE_Custom)
+	{
+		return false;
+	}
+
+	if (LastScan.ScanTime < 0.0f)
+	{
+		return true;
+	}
+
+	if (FVector::DistSquared(CachedCharacterOwner->GetActorLocation(), LastScan.ScanLocation) >= FMath::Square(ScanDistanceThreshold)
+		|| FVector::DotProduct(CachedCharacterOwner->GetActorForwardVector(), LastScan.ScanForward) < FMath::Cos(FMath::DegreesToRadians(MaxScanAngleDeviation)))
+	{
+		return true;
+	}
+
+	return !CachedCharacterOwner->GetVelocity().IsNearlyZero() && GetWorld()->GetTimeSeconds() - LastScan.ScanTime >= ScanInterval;
+}
+
+void ULedgeDetectorComponent::Scan()
+{
+	INC_DWORD_STAT(STAT_LedgeScans);
+
+	FLedgeDescription LedgeDescription;
+	LastScan.bHasLedge = DetectLedgeUncached(LedgeDescription, false);
+	LastScan.LedgeDescription = LedgeDescription;
+	LastScan.ScanLocation = CachedCharacterOwner->GetActorLocation();
+	LastScan.ScanForward = CachedCharacterOwner->GetActorForwardVector();
+	LastScan.ScanTime = GetWorld()->GetTimeSeconds();
 }
\ No newline at end of file
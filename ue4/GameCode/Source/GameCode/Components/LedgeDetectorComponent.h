@@ -28,6 +28,15 @@ struct FLedgeDescription
 	FRotator Rotation;
 };
 
+struct FLedgeScanResult
+{
+	FLedgeDescription LedgeDescription;
+	FVector ScanLocation = FVector::ZeroVector;
+	FVector ScanForward = FVector::ForwardVector;
+	float ScanTime = -1.0f;
+	bool bHasLedge = false;
+};
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class GAMECODE_API ULedgeDetectorComponent : public UActorComponent
@@ -35,9 +44,16 @@ class GAMECODE_API ULedgeDetectorComponent : public UActorComponent
 	GENERATED_BODY()
 
 public:
+	ULedgeDetectorComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	// Answered from the background scan when it is still valid for the current owner location, falls back to the full detection otherwise
 	bool DetectLedge(OUT FLedgeDescription& LedgeDescription);
 
+	// Only the locally controlled player scans in the background, the owner calls it whenever its controller changes
+	void OnOwnerControllerChanged();
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -50,7 +66,34 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Detection settings", meta = (UIMin = 0.0f, ClampMin = 0.0f))
 	float ForwardCheckDistance = 100.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ledge cache", meta = (UIMin = 0.0f, ClampMin = 0.0f))
+	float ScanInterval = 0.25f;
+
+	// Owner moving this far from the last scan location triggers a rescan before the interval runs out
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ledge cache", meta = (UIMin = 0.0f, ClampMin = 0.0f))
+	float ScanDistanceThreshold = 50.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ledge cache", meta = (UIMin = 0.0f, ClampMin = 0.0f))
+	float MaxScanAge = 0.5f;
+
+	// Sideways shift along the ledge a cached ledge can be reused with
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ledge cache", meta = (UIMin = 0.0f, ClampMin = 0.0f))
+	float MaxLateralOffset = 25.0f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ledge cache", meta = (UIMin = 0.0f, ClampMin = 0.0f, UIMax = 90.0f, ClampMax = 90.0f))
+	float MaxScanAngleDeviation = 15.0f;
 	
 private:
+	bool DetectLedgeUncached(OUT FLedgeDescription& LedgeDescription, bool bIsDebugEnabled) const;
+	bool TryGetScannedLedge(OUT FLedgeDescription& LedgeDescription, OUT bool& bHasLedge, bool bIsDebugEnabled) const;
+	bool ShouldScan() const;
+	void Scan();
+
 	TWeakObjectPtr<class ACharacter> CachedCharacterOwner;
+
+	FCollisionQueryParams LedgeQueryParams;
+	float DefaultCapsuleHalfHeight = 0.0f;
+
+	FLedgeScanResult LastScan;
 };
@@ -4,18 +4,36 @@
 #include "WeaponBarellComponent.h"
 #include "GameCodeTypes.h"
 #include "DrawDebugHelpers.h"
+#include "Subsystems/AssetStreamingSubsystem.h"
+#include "Subsystems/DamageSubsystem.h"
 #include "Subsystems/DebugSubsystem.h"
+#include "Subsystems/HitscanSubsystem.h"
+#include "Subsystems/ImpactFXSubsystem.h"
+#include "Utils/GCTelemetry.h"
 #include "Kismet/GameplayStatics.h"
-#include "NiagaraFunctionLibrary.h"
 #include "NiagaraComponent.h"
-#include <Components/DecalComponent.h>
+#include "NiagaraSystem.h"
 
 void UWeaponBarellComponent::Shot(FVector ShotStart, FVector ShotDirection, AController* Controller)
 {
-	FVector MuzzleLocation = GetComponentLocation();
-	FVector ShotEnd = ShotStart + FiringRange * ShotDirection;
+	FHitscanShotRequest ShotRequest;
+	ShotRequest.Barell = this;
+	ShotRequest.Instigator = Controller;
+	ShotRequest.ShooterId = GetOwner()->GetUniqueID();
+	ShotRequest.MuzzleLocation = GetComponentLocation();
+	ShotRequest.MuzzleRotation = GetComponentRotation();
+	ShotRequest.ShotStart = ShotStart;
+	ShotRequest.ShotEnd = ShotStart + FiringRange * ShotDirection;
 
-	UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), MuzzleFlashFX, MuzzleLocation, GetComponentRotation());
+	GetWorld()->GetSubsystem<UImpactFXSubsystem>()->SpawnNiagaraSystem(GCAssetStreaming::GetOrLoadAsset(MuzzleFlashFX), ShotRequest.MuzzleLocation, ShotRequest.MuzzleRotation);
+
+	GetWorld()->GetSubsystem<UHitscanSubsystem>()->SubmitShot(ShotRequest);
+}
+
+void UWeaponBarellComponent::ProcessShotResult(const FHitscanShotRequest& ShotRequest, const FHitResult& ShotResult)
+{
+	FVector MuzzleLocation = ShotRequest.MuzzleLocation;
+	FVector ShotEnd = ShotRequest.ShotEnd;
 
 #if ENABLE_DRAW_DEBUG
 	UDebugSubsystem* DebugSubSystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UDebugSubsystem>();
@@ -24,8 +42,8 @@ void UWeaponBarellComponent::Shot(FVector ShotStart, FVector ShotDirection, ACon
 	bool bIsDebugEnabled = false;
 #endif
 
-	FHitResult ShotResult;
-	if (GetWorld()->LineTraceSingleByChannel(ShotResult, ShotStart, ShotEnd, ECC_Bullet))
+	UImpactFXSubsystem* ImpactFXSubsystem = GetWorld()->GetSubsystem<UImpactFXSubsystem>();
+	if (ShotResult.bBlockingHit)
 	{
 		ShotEnd = ShotResult.ImpactPoint;
 		if (bIsDebugEnabled)
@@ -42,22 +60,37 @@ void UWeaponBarellComponent::Shot(FVector ShotStart, FVector ShotDirection, ACon
 			{
 				DamageAmount *= FallOffDamage->GetFloatValue(ShotDistance / FiringRange);
 			}
-			HitActor->TakeDamage(DamageAmount, FDamageEvent{}, Controller, GetOwner());
+			GCTelemetry::RecordEvent(ETelemetryEventType::Hit, GetOwner(), HitActor, DamageAmount, ShotEnd);
+			GetWorld()->GetSubsystem<UDamageSubsystem>()->SubmitDamage(HitActor, DamageAmount, ShotRequest.Instigator.Get(), GetOwner());
 		}
+
+		ImpactFXSubsystem->SpawnDecal(DefaultShotDecalInfo, ShotEnd, ShotResult.ImpactNormal.ToOrientationRotator());
 	}
 
-	UDecalComponent* DecalComponent = UGameplayStatics::SpawnDecalAtLocation(GetWorld(), DefaultShotDecalInfo.DecalMaterial, DefaultShotDecalInfo.DecalSize, ShotEnd, ShotResult.ImpactNormal.ToOrientationRotator());
-	if (IsValid(DecalComponent))
+	UNiagaraComponent* TraceFXComponent = ImpactFXSubsystem->SpawnNiagaraSystem(GCAssetStreaming::GetOrLoadAsset(TraceFX), MuzzleLocation, ShotRequest.MuzzleRotation);
+	if (IsValid(TraceFXComponent))
 	{
-		DecalComponent->SetFadeScreenSize(0.0001f);
-		DecalComponent->SetFadeOut(DefaultShotDecalInfo.DecalLifeTime, DefaultShotDecalInfo.DecalFadeOutTime);
+		TraceFXComponent->SetVectorParameter(FXParamTraceEnd, ShotEnd);
 	}
-	
-	UNiagaraComponent* TraceFXComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), TraceFX, MuzzleLocation, GetComponentRotation());
-	TraceFXComponent->SetVectorParameter(FXParamTraceEnd, ShotEnd);
 
 	if (bIsDebugEnabled)
 	{
 		DrawDebugLine(GetWorld(), MuzzleLocation, ShotEnd, FColor::Red, false, 1.0f, 0, 3.0f);
 	}
 }
+
+void UWeaponBarellComponent::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	if (!MuzzleFlashFX.IsNull())
+	{
+		OutAssets.Add(MuzzleFlashFX.ToSoftObjectPath());
+	}
+	if (!TraceFX.IsNull())
+	{
+		OutAssets.Add(TraceFX.ToSoftObjectPath());
+	}
+	if (!DefaultShotDecalInfo.DecalMaterial.IsNull())
+	{
+		OutAssets.Add(DefaultShotDecalInfo.DecalMaterial.ToSoftObjectPath());
+	}
+}
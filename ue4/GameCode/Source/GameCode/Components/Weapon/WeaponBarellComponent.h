@@ -12,7 +12,7 @@ struct FDecalInfo
 	GENERATED_BODY()
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	UMaterialInterface* DecalMaterial;
+	TSoftObjectPtr<UMaterialInterface> DecalMaterial;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FVector DecalSize = FVector(3.f, 3.f, 3.f);
@@ -25,6 +25,7 @@ struct FDecalInfo
 };
 
 class UNiagaraSystem;
+struct FHitscanShotRequest;
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class GAMECODE_API UWeaponBarellComponent : public USceneComponent
 {
@@ -32,6 +33,9 @@ class GAMECODE_API UWeaponBarellComponent : public USceneComponent
 
 public:	
 	void Shot(FVector ShotStart, FVector ShotDirection, AController* Controller);
+	void ProcessShotResult(const FHitscanShotRequest& ShotRequest, const FHitResult& ShotResult);
+
+	void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const;
 
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Barell attributes")
@@ -44,10 +48,10 @@ protected:
 	UCurveFloat* FallOffDamage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Barell attributes | VFX")
-	UNiagaraSystem* MuzzleFlashFX;
+	TSoftObjectPtr<UNiagaraSystem> MuzzleFlashFX;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Barell attributes | VFX")
-	UNiagaraSystem* TraceFX;
+	TSoftObjectPtr<UNiagaraSystem> TraceFX;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Barell attributes | Decals")
 	FDecalInfo DefaultShotDecalInfo;
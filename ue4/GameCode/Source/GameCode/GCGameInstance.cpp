@@ -16,5 +16,14 @@ bool UGCGameInstance::ProcessConsoleExec(const TCHAR* Cmd, FOutputDevice& Ar, UO
 		}
 	}
 
+	if (!bResult && IsValid(GetWorld()))
+	{
+		const TArray<UWorldSubsystem*>& WorldSubsystems = GetWorld()->GetSubsystemArray<UWorldSubsystem>();
+		for (UWorldSubsystem* Subsystem : WorldSubsystems)
+		{
+			bResult |= Subsystem->ProcessConsoleExec(Cmd, Ar, Executor);
+		}
+	}
+
 	return bResult;
 }
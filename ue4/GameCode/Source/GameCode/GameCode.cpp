@@ -1,6 +1,9 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "GameCode.h"
+#include "GameCodeTypes.h"
 #include "Modules/ModuleManager.h"
 
+CSV_DEFINE_CATEGORY_MODULE(GAMECODE_API, GameCode, true);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GameCode, "GameCode" );
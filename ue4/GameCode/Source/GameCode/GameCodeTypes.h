@@ -1,10 +1,15 @@
 #pragma once
 
+#include "ProfilingDebugging/CsvProfiler.h"
+
 #define ECC_Climbing ECC_GameTraceChannel1
 #define ECC_InteractionVolume ECC_GameTraceChannel2
 #define ECC_WallRunnable ECC_GameTraceChannel3
 #define ECC_Bullet ECC_GameTraceChannel4
 
+DECLARE_STATS_GROUP(TEXT("GameCode"), STATGROUP_GameCode, STATCAT_Advanced);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GAMECODE_API, GameCode);
+
 const FName CollisionProfilePawn = FName("Pawn");
 const FName CollisionProfileIgnorePawn = FName("IgnoreOnlyPawn");
 const FName CollisionProfilePawnInteractionVolume = FName("PawnInteractionVolume");
@@ -18,6 +23,7 @@ const FName SocketWeaponForeGrip = FName("ForeGripSocket");
 const FName DebugCategoryLedgeDetection = FName("LedgeDetection");
 const FName DebugCategoryCharacterAttributes = FName("CharacterAttributes");
 const FName DebugCategoryRangeWeapon = FName("RangeWeapon");
+const FName DebugCategoryFootIK = FName("FootIK");
 
 const FName FXParamTraceEnd = FName("TraceEnd");
 
@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AIThinkBudgetSubsystem.h"
+#include "AIController.h"
+#include "GameCodeTypes.h"
+#include "Characters/GCBaseCharacter.h"
+#include "Subsystems/CombatSnapshotSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI thinks"), STAT_AIThinks, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI thinks deferred"), STAT_AIThinksDeferred, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("AI thinks process"), STAT_AIThinksProcess, STATGROUP_GameCode);
+
+void FAIThinkBatch::Reset()
+{
+	AgentIndices.Reset();
+	TargetIndices.Reset();
+	MaxFireDistancesSquared.Reset();
+	Decisions.Reset();
+}
+
+void UAIThinkBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UAIThinkBudgetSubsystem::OnWorldPostActorTick);
+}
+
+void UAIThinkBudgetSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingRequests.Empty();
+	PendingRequestIndices.Empty();
+	Super::Deinitialize();
+}
+
+void UAIThinkBudgetSubsystem::RequestFireThink(AAIController* Controller, FName TargetKeyName, float MaxFireDistance)
+{
+	// Repeated request keeps the deferred frames of the pending one
+	int32* RequestIndex = PendingRequestIndices.Find(Controller);
+	FAIThinkRequest& Request = RequestIndex != nullptr ? PendingRequests[*RequestIndex] : PendingRequests.AddDefaulted_GetRef();
+	if (RequestIndex == nullptr)
+	{
+		PendingRequestIndices.Add(Controller, PendingRequests.Num() - 1);
+	}
+
+	Request.Controller = Controller;
+	Request.TargetKeyName = TargetKeyName;
+	Request.MaxFireDistance = MaxFireDistance;
+}
+
+void UAIThinkBudgetSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && PendingRequests.Num() > 0)
+	{
+		ProcessPendingRequests();
+	}
+}
+
+void UAIThinkBudgetSubsystem::ProcessPendingRequests()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIThinksProcess);
+	CSV_SCOPED_TIMING_STAT(GameCode, AIThink);
+
+	const UCombatSnapshotSubsystem* CombatSnapshotSubsystem = GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>();
+	const FCombatSnapshot& CombatSnapshot = CombatSnapshotSubsystem->GetSnapshot();
+
+	FVector PlayerLocation = FVector::ZeroVector;
+	bool bHasPlayer = false;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (IsValid(PlayerController) && IsValid(PlayerController->GetPawn()))
+	{
+		PlayerLocation = PlayerController->GetPawn()->GetActorLocation();
+		bHasPlayer = true;
+	}
+
+	PendingAgentIndices.SetNumUninitialized(PendingRequests.Num());
+	PendingTargetIndices.SetNumUninitialized(PendingRequests.Num());
+	PendingPriorities.SetNumUninitialized(PendingRequests.Num());
+	SortedRequestIndices.Reset();
+	for (int32 i = 0; i < PendingRequests.Num(); ++i)
+	{
+		const AAIController* Controller = PendingRequests[i].Controller.Get();
+		int32 AgentIndex = IsValid(Controller) ? CombatSnapshotSubsystem->FindIndex(Controller->GetPawn()) : INDEX_NONE;
+		PendingAgentIndices[i] = AgentIndex;
+		if (AgentIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		PendingTargetIndices[i] = CombatSnapshotSubsystem->FindTargetIndex(Controller, PendingRequests[i].TargetKeyName);
+
+		// Lower is more urgent
+		float Priority = bHasPlayer ? FVector::Dist(CombatSnapshot.Locations[AgentIndex], PlayerLocation) : 0.0f;
+		Priority -= PendingTargetIndices[i] != INDEX_NONE ? CombatPriorityDistance : 0.0f;
+		Priority -= PendingRequests[i].DeferredFrames * DeferredFramePriorityDistance;
+		PendingPriorities[i] = Priority;
+		SortedRequestIndices.Add(i);
+	}
+
+	const TArray<float>& Priorities = PendingPriorities;
+	SortedRequestIndices.Sort([&Priorities](int32 A, int32 B) { return Priorities[A] < Priorities[B]; });
+
+	int32 ThinksCount = FMath::Min(FMath::Max(MaxThinksPerFrame, 1), SortedRequestIndices.Num());
+	int32 DeferredCount = SortedRequestIndices.Num() - ThinksCount;
+	SortedRequestIndices.SetNum(ThinksCount, false);
+
+	Batch.Reset();
+	for (int32 RequestIndex : SortedRequestIndices)
+	{
+		Batch.AgentIndices.Add(PendingAgentIndices[RequestIndex]);
+		Batch.TargetIndices.Add(PendingTargetIndices[RequestIndex]);
+		Batch.MaxFireDistancesSquared.Add(FMath::Square(PendingRequests[RequestIndex].MaxFireDistance));
+	}
+	MakeDecisions(CombatSnapshot);
+	ApplyDecisions(CombatSnapshot);
+
+	INC_DWORD_STAT_BY(STAT_AIThinks, ThinksCount);
+	INC_DWORD_STAT_BY(STAT_AIThinksDeferred, DeferredCount);
+	CSV_CUSTOM_STAT(GameCode, AIThinks, ThinksCount, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GameCode, AIThinksDeferred, DeferredCount, ECsvCustomStatOp::Set);
+
+	// Processed and stale requests leave the queue, the rest wait for the next frame.
+	// Pawn missing from the snapshot is dead, unpossessed or not captured yet, its service asks again while it's still relevant
+	TArray<bool, TInlineAllocator<64>> bIsProcessed;
+	bIsProcessed.SetNumZeroed(PendingRequests.Num());
+	for (int32 RequestIndex : SortedRequestIndices)
+	{
+		bIsProcessed[RequestIndex] = true;
+	}
+
+	PendingRequestIndices.Reset();
+	int32 KeptCount = 0;
+	for (int32 i = 0; i < PendingRequests.Num(); ++i)
+	{
+		if (bIsProcessed[i] || PendingAgentIndices[i] == INDEX_NONE)
+		{
+			continue;
+		}
+		FAIThinkRequest& KeptRequest = PendingRequests[KeptCount];
+		KeptRequest = PendingRequests[i];
+		++KeptRequest.DeferredFrames;
+		PendingRequestIndices.Add(KeptRequest.Controller, KeptCount);
+		++KeptCount;
+	}
+	PendingRequests.SetNum(KeptCount, false);
+	Batch.Reset();
+}
+
+void UAIThinkBudgetSubsystem::MakeDecisions(const FCombatSnapshot& CombatSnapshot)
+{
+	Batch.Decisions.SetNumUninitialized(Batch.AgentIndices.Num());
+	for (int32 i = 0; i < Batch.AgentIndices.Num(); ++i)
+	{
+		int32 AgentIndex = Batch.AgentIndices[i];
+		int32 TargetIndex = Batch.TargetIndices[i];
+		ECombatWeaponState WeaponState = CombatSnapshot.WeaponStates[AgentIndex];
+
+		EAIFireDecision Decision = EAIFireDecision::None;
+		if (CombatSnapshot.bIsAlive[AgentIndex] && WeaponState != ECombatWeaponState::None)
+		{
+			bool bIsInRange = TargetIndex != INDEX_NONE
+				&& FVector::DistSquared(CombatSnapshot.Locations[AgentIndex], CombatSnapshot.Locations[TargetIndex]) <= Batch.MaxFireDistancesSquared[i];
+			if (!bIsInRange)
+			{
+				Decision = EAIFireDecision::StopFire;
+			}
+			else if (WeaponState == ECombatWeaponState::Idle)
+			{
+				Decision = EAIFireDecision::StartFire;
+			}
+		}
+		Batch.Decisions[i] = Decision;
+	}
+}
+
+void UAIThinkBudgetSubsystem::ApplyDecisions(const FCombatSnapshot& CombatSnapshot)
+{
+	for (int32 i = 0; i < Batch.AgentIndices.Num(); ++i)
+	{
+		if (Batch.Decisions[i] == EAIFireDecision::None)
+		{
+			continue;
+		}
+
+		// Pawns of the snapshot may have been destroyed during the frame
+		AGCBaseCharacter* Character = Cast<AGCBaseCharacter>(CombatSnapshot.Pawns[Batch.AgentIndices[i]]);
+		if (!IsValid(Character))
+		{
+			continue;
+		}
+
+		if (Batch.Decisions[i] == EAIFireDecision::StartFire)
+		{
+			Character->StartFire();
+		}
+		else
+		{
+			Character->StopFire();
+		}
+	}
+}
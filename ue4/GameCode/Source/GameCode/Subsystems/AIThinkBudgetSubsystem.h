@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AIThinkBudgetSubsystem.generated.h"
+
+class AAIController;
+struct FCombatSnapshot;
+struct FAIThinkRequest
+{
+	TWeakObjectPtr<AAIController> Controller;
+	FName TargetKeyName;
+	float MaxFireDistance = 0.0f;
+
+	// Frames the request was deferred by the budget, raises its priority
+	int32 DeferredFrames = 0;
+};
+
+enum class EAIFireDecision : uint8
+{
+	None,
+	StartFire,
+	StopFire
+};
+
+/**
+ * Agents picked to think this frame, as indices into the combat snapshot
+ */
+struct FAIThinkBatch
+{
+	TArray<int32> AgentIndices;
+	TArray<int32> TargetIndices;
+	TArray<float> MaxFireDistancesSquared;
+
+	TArray<EAIFireDecision> Decisions;
+
+	void Reset();
+};
+
+/**
+ * Caps the amount of AI fire decisions per frame. Pending agents are picked by distance to the player and combat state,
+ * deferred ones gain priority every frame, so every agent gets its turn
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UAIThinkBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RequestFireThink(AAIController* Controller, FName TargetKeyName, float MaxFireDistance);
+
+protected:
+	UPROPERTY(Config)
+	int32 MaxThinksPerFrame = 8;
+
+	// Agent with a target is treated as this much closer to the player
+	UPROPERTY(Config)
+	float CombatPriorityDistance = 2000.0f;
+
+	// Deferred agent is treated as this much closer to the player for every frame it waited
+	UPROPERTY(Config)
+	float DeferredFramePriorityDistance = 500.0f;
+
+private:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void ProcessPendingRequests();
+	void MakeDecisions(const FCombatSnapshot& CombatSnapshot);
+	void ApplyDecisions(const FCombatSnapshot& CombatSnapshot);
+
+	TArray<FAIThinkRequest> PendingRequests;
+	TMap<TWeakObjectPtr<AAIController>, int32> PendingRequestIndices;
+
+	TArray<int32> PendingAgentIndices;
+	TArray<int32> PendingTargetIndices;
+	TArray<float> PendingPriorities;
+	TArray<int32> SortedRequestIndices;
+
+	FAIThinkBatch Batch;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,256 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AnimBudgetSubsystem.h"
+#include "GameCodeTypes.h"
+#include "Algo/Sort.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Subsystems/FootIKSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim budget full rate meshes"), STAT_AnimBudgetFullMeshes, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim budget reduced rate meshes"), STAT_AnimBudgetReducedMeshes, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Anim budget offscreen meshes"), STAT_AnimBudgetOffscreenMeshes, STATGROUP_GameCode);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Anim budget estimated cost ms"), STAT_AnimBudgetEstimatedCost, STATGROUP_GameCode);
+
+static TAutoConsoleVariable<int32> CVarAnimBudgetEnabled(
+	TEXT("gc.AnimBudget.Enabled"),
+	1,
+	TEXT("0 - every registered mesh updates at full rate, 1 - update rates are lowered to fit the animation budget"),
+	ECVF_Default);
+
+void UAnimBudgetSubsystem::Deinitialize()
+{
+	for (FAnimBudgetEntry& Entry : Entries)
+	{
+		SetExternallyControlled(Entry, false, 0);
+	}
+	Entries.Empty();
+	SortedIndices.Empty();
+	TickRates.Empty();
+	Super::Deinitialize();
+}
+
+void UAnimBudgetSubsystem::Tick(float DeltaTime)
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	// Skipped frames are decided every frame, rates only every EvaluationInterval
+	UpdateExternallyControlled(DeltaTime);
+
+	EvaluationTimer -= DeltaTime;
+	if (EvaluationTimer > 0.0f)
+	{
+		return;
+	}
+	EvaluationTimer = EvaluationInterval;
+
+	CSV_SCOPED_TIMING_STAT(GameCode, AnimBudget);
+
+	FVector ViewLocation = FVector::ZeroVector;
+	bool bHasViewLocation = false;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (IsValid(PlayerController) && IsValid(PlayerController->PlayerCameraManager))
+	{
+		ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+		bHasViewLocation = true;
+	}
+
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		if (!Entries[i].Pawn.IsValid() || !Entries[i].Mesh.IsValid())
+		{
+			Entries.RemoveAtSwap(i);
+			continue;
+		}
+		EvaluateEntry(Entries[i], bHasViewLocation ? &ViewLocation : nullptr);
+	}
+
+	float EstimatedCost = AllocateBudget();
+
+	int32 FullMeshesCount = 0;
+	int32 ReducedMeshesCount = 0;
+	int32 OffscreenMeshesCount = 0;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		FAnimBudgetEntry& Entry = Entries[i];
+		bool bIsOffscreen = !Entry.bIsFixedRate && !Entry.bIsRendered;
+		bool bIsInterpolated = TickRates[i] > 1 && Entry.bIsRendered && Entry.Distance < InterpolationDistance;
+		ApplyEntry(Entry, TickRates[i], bIsInterpolated, bIsOffscreen, DeltaTime);
+		SetExternallyControlled(Entry, !Entry.bIsFixedRate, i);
+
+		FullMeshesCount += TickRates[i] == 1 ? 1 : 0;
+		ReducedMeshesCount += TickRates[i] > 1 && !bIsOffscreen ? 1 : 0;
+		OffscreenMeshesCount += bIsOffscreen ? 1 : 0;
+	}
+
+	SET_DWORD_STAT(STAT_AnimBudgetFullMeshes, FullMeshesCount);
+	SET_DWORD_STAT(STAT_AnimBudgetReducedMeshes, ReducedMeshesCount);
+	SET_DWORD_STAT(STAT_AnimBudgetOffscreenMeshes, OffscreenMeshesCount);
+	SET_FLOAT_STAT(STAT_AnimBudgetEstimatedCost, EstimatedCost);
+	CSV_CUSTOM_STAT(GameCode, AnimBudgetEstimatedCostMs, EstimatedCost, ECsvCustomStatOp::Set);
+}
+
+TStatId UAnimBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimBudgetSubsystem, STATGROUP_GameCode);
+}
+
+void UAnimBudgetSubsystem::RegisterMesh(APawn* Pawn, USkeletalMeshComponent* Mesh, int32 FootIKAgentId, const FOnAnimTickRateChanged& OnTickRateChanged)
+{
+	FAnimBudgetEntry Entry;
+	Entry.Pawn = Pawn;
+	Entry.Mesh = Mesh;
+	Entry.FootIKAgentId = FootIKAgentId;
+	Entry.OnTickRateChanged = OnTickRateChanged;
+	Entry.DefaultVisibilityBasedAnimTickOption = Mesh->VisibilityBasedAnimTickOption;
+
+	// External control is enabled only once the mesh gets budgeted, until then it ticks on its own
+	Mesh->bEnableUpdateRateOptimizations = true;
+	Entries.Add(MoveTemp(Entry));
+}
+
+void UAnimBudgetSubsystem::UnregisterMesh(APawn* Pawn)
+{
+	Entries.RemoveAllSwap([this, Pawn](FAnimBudgetEntry& Entry)
+	{
+		if (Entry.Pawn.Get() != Pawn)
+		{
+			return false;
+		}
+		SetExternallyControlled(Entry, false, 0);
+		return true;
+	});
+}
+
+void UAnimBudgetSubsystem::EvaluateEntry(FAnimBudgetEntry& Entry, const FVector* ViewLocation) const
+{
+	USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+	Entry.Distance = ViewLocation != nullptr ? FVector::Dist(Mesh->GetComponentLocation(), *ViewLocation) : 0.0f;
+	Entry.bIsRendered = Mesh->WasRecentlyRendered(VisibilityTolerance);
+	Entry.bIsFixedRate = Entry.Pawn->IsPlayerControlled() || Entry.Distance < NearDistance || CVarAnimBudgetEnabled.GetValueOnGameThread() == 0;
+
+	// Rendered meshes are always more significant than offscreen ones, closer meshes are more significant than further ones
+	float DistanceSignificance = NearDistance / FMath::Max(Entry.Distance, NearDistance);
+	Entry.Significance = Entry.bIsFixedRate ? 2.0f : (Entry.bIsRendered ? 1.0f : 0.0f) + 0.5f * DistanceSignificance;
+}
+
+float UAnimBudgetSubsystem::AllocateBudget()
+{
+	TickRates.SetNumUninitialized(Entries.Num());
+	SortedIndices.Reset();
+
+	float Cost = 0.0f;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		const FAnimBudgetEntry& Entry = Entries[i];
+		if (!Entry.bIsFixedRate && !Entry.bIsRendered)
+		{
+			TickRates[i] = OffscreenTickRate;
+			Cost += MeshUpdateCostMs / OffscreenTickRate;
+			continue;
+		}
+
+		TickRates[i] = 1;
+		Cost += MeshUpdateCostMs;
+		if (!Entry.bIsFixedRate)
+		{
+			SortedIndices.Add(i);
+		}
+	}
+
+	// The least significant meshes are slowed down first, the last one only as much as is needed to fit the budget
+	Algo::Sort(SortedIndices, [this](int32 A, int32 B) { return Entries[A].Significance < Entries[B].Significance; });
+	for (int32 i = 0; i < SortedIndices.Num() && Cost > BudgetMs; ++i)
+	{
+		float Excess = Cost - BudgetMs;
+		int32 TickRate = MaxTickRate;
+		if (Excess < MeshUpdateCostMs * (1.0f - 1.0f / MaxTickRate))
+		{
+			TickRate = FMath::Clamp(FMath::CeilToInt(MeshUpdateCostMs / (MeshUpdateCostMs - Excess)), 2, MaxTickRate);
+		}
+		TickRates[SortedIndices[i]] = TickRate;
+		Cost -= MeshUpdateCostMs * (1.0f - 1.0f / TickRate);
+	}
+
+	return Cost;
+}
+
+void UAnimBudgetSubsystem::ApplyEntry(FAnimBudgetEntry& Entry, int32 TickRate, bool bIsInterpolated, bool bIsOffscreen, float DeltaTime)
+{
+	if (Entry.TickRate == TickRate && Entry.bIsInterpolated == bIsInterpolated && Entry.bIsOffscreen == bIsOffscreen)
+	{
+		return;
+	}
+
+	USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+	Mesh->SetExternalTickRate(TickRate);
+	Mesh->EnableExternalInterpolation(bIsInterpolated);
+	Mesh->VisibilityBasedAnimTickOption = bIsOffscreen ? EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered : Entry.DefaultVisibilityBasedAnimTickOption;
+
+	// Feet are sampled by the pose only every TickRate frames, probing them more often is wasted
+	if (Entry.FootIKAgentId != INDEX_NONE)
+	{
+		GetWorld()->GetSubsystem<UFootIKSubsystem>()->SetAgentMinUpdateInterval(Entry.FootIKAgentId, (TickRate - 1) * DeltaTime);
+	}
+
+	if (Entry.TickRate != TickRate)
+	{
+		Entry.OnTickRateChanged.ExecuteIfBound(TickRate);
+	}
+
+	Entry.TickRate = TickRate;
+	Entry.bIsInterpolated = bIsInterpolated;
+	Entry.bIsOffscreen = bIsOffscreen;
+}
+
+void UAnimBudgetSubsystem::SetExternallyControlled(FAnimBudgetEntry& Entry, bool bIsExternallyControlled, int32 StaggerIndex)
+{
+	USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+	if (Entry.bIsExternallyControlled == bIsExternallyControlled || !IsValid(Mesh))
+	{
+		return;
+	}
+
+	Entry.bIsExternallyControlled = bIsExternallyControlled;
+	Mesh->EnableExternalTickRateControl(bIsExternallyControlled);
+	if (bIsExternallyControlled)
+	{
+		// Meshes budgeted at once don't all update on the same frame
+		Entry.FramesUntilUpdate = 1 + StaggerIndex % FMath::Max(Entry.TickRate, 1);
+		Entry.AccumulatedDeltaTime = 0.0f;
+	}
+	else
+	{
+		Mesh->EnableExternalUpdate(false);
+	}
+}
+
+void UAnimBudgetSubsystem::UpdateExternallyControlled(float DeltaTime)
+{
+	for (FAnimBudgetEntry& Entry : Entries)
+	{
+		USkeletalMeshComponent* Mesh = Entry.Mesh.Get();
+		if (!Entry.bIsExternallyControlled || !IsValid(Mesh))
+		{
+			continue;
+		}
+
+		// With external control the mesh updates only when told to, over the time passed since its previous update
+		Entry.AccumulatedDeltaTime += DeltaTime;
+		Entry.FramesUntilUpdate = FMath::Min(Entry.FramesUntilUpdate - 1, Entry.TickRate - 1);
+		bool bShouldUpdate = Entry.FramesUntilUpdate <= 0;
+		Mesh->EnableExternalUpdate(bShouldUpdate);
+		Mesh->SetExternalDeltaTime(Entry.AccumulatedDeltaTime);
+		Mesh->SetExternalInterpolationAlpha(Entry.bIsInterpolated ? 0.25f + 1.0f / (FMath::Max(Entry.TickRate, 2) * 2) : 1.0f);
+		if (bShouldUpdate)
+		{
+			Entry.FramesUntilUpdate = Entry.TickRate;
+			Entry.AccumulatedDeltaTime = 0.0f;
+		}
+	}
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Subsystems/GCTickableWorldSubsystem.h"
+#include "AnimBudgetSubsystem.generated.h"
+
+DECLARE_DELEGATE_OneParam(FOnAnimTickRateChanged, int32);
+
+struct FAnimBudgetEntry
+{
+	TWeakObjectPtr<APawn> Pawn;
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+	int32 FootIKAgentId = INDEX_NONE;
+	FOnAnimTickRateChanged OnTickRateChanged;
+	EVisibilityBasedAnimTickOption DefaultVisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPose;
+
+	float Significance = 0.0f;
+	float Distance = 0.0f;
+	bool bIsRendered = true;
+	bool bIsFixedRate = true;
+
+	int32 TickRate = 1;
+	bool bIsInterpolated = false;
+	bool bIsOffscreen = false;
+
+	// Only budgeted meshes are under external control, full rate ones including the local player tick on their own
+	bool bIsExternallyControlled = false;
+	int32 FramesUntilUpdate = 0;
+	float AccumulatedDeltaTime = 0.0f;
+};
+
+/**
+ * Keeps game thread animation cost of registered meshes within BudgetMs by lowering update rates of the least significant ones.
+ * Rates are applied through external tick rate control of the mesh driven every frame the way the engine animation budget allocator does,
+ * skipped frames don't call NativeUpdateAnimation, and offscreen meshes only tick montages so their notifies still fire
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UAnimBudgetSubsystem : public UGCTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterMesh(APawn* Pawn, USkeletalMeshComponent* Mesh, int32 FootIKAgentId, const FOnAnimTickRateChanged& OnTickRateChanged);
+	void UnregisterMesh(APawn* Pawn);
+
+protected:
+	UPROPERTY(Config)
+	float BudgetMs = 2.0f;
+
+	// Assumed game thread cost of one mesh updated at full rate. It's a fixed estimate to tune against stat anim, not a measurement
+	UPROPERTY(Config)
+	float MeshUpdateCostMs = 0.1f;
+
+	// Meshes closer than that always update at full rate
+	UPROPERTY(Config)
+	float NearDistance = 1500.0f;
+
+	// Reduced rate meshes closer than that are interpolated between updates
+	UPROPERTY(Config)
+	float InterpolationDistance = 4000.0f;
+
+	UPROPERTY(Config)
+	int32 MaxTickRate = 4;
+
+	UPROPERTY(Config)
+	int32 OffscreenTickRate = 10;
+
+	UPROPERTY(Config)
+	float VisibilityTolerance = 0.2f;
+
+	UPROPERTY(Config)
+	float EvaluationInterval = 0.1f;
+
+private:
+	void EvaluateEntry(FAnimBudgetEntry& Entry, const FVector* ViewLocation) const;
+	float AllocateBudget();
+	void ApplyEntry(FAnimBudgetEntry& Entry, int32 TickRate, bool bIsInterpolated, bool bIsOffscreen, float DeltaTime);
+	void SetExternallyControlled(FAnimBudgetEntry& Entry, bool bIsExternallyControlled, int32 StaggerIndex);
+	void UpdateExternallyControlled(float DeltaTime);
+
+	TArray<FAnimBudgetEntry> Entries;
+	TArray<int32> SortedIndices;
+	TArray<int32> TickRates;
+	float EvaluationTimer = 0.0f;
+};
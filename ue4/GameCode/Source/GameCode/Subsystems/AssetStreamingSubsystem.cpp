@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AssetStreamingSubsystem.h"
+#include "GameCodeTypes.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAssetStreaming, Display, Display)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Streamed assets sync load stalls"), STAT_AssetStreamingStalls, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Streamed assets async loads"), STAT_AssetStreamingAsyncLoads, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Streamed assets sync load"), STAT_AssetStreamingSyncLoad, STATGROUP_GameCode);
+
+static TAutoConsoleVariable<int32> CVarAssetStreamingEnabled(
+	TEXT("gc.AssetStreaming.Enabled"),
+	1,
+	TEXT("Soft referenced equipment assets are streamed in ahead of use, otherwise they're loaded on first use"),
+	ECVF_Default);
+
+static int32 SyncLoadStallsCount = 0;
+static double SyncLoadStallsTime = 0.0;
+
+UObject* GCAssetStreaming::GetOrLoadAsset(const FSoftObjectPath& AssetPath)
+{
+	UObject* Result = AssetPath.ResolveObject();
+	if (Result != nullptr || AssetPath.IsNull())
+	{
+		return Result;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AssetStreamingSyncLoad);
+	INC_DWORD_STAT(STAT_AssetStreamingStalls);
+	double StartTime = FPlatformTime::Seconds();
+	Result = AssetPath.TryLoad();
+	double StallTime = FPlatformTime::Seconds() - StartTime;
+
+	++SyncLoadStallsCount;
+	SyncLoadStallsTime += StallTime;
+	CSV_CUSTOM_STAT(GameCode, AssetStreamingStallMs, (float)(StallTime * 1000.0), ECsvCustomStatOp::Accumulate);
+	UE_LOG(LogAssetStreaming, Verbose, TEXT("%s was loaded synchronously in %.3f ms"), *AssetPath.ToString(), StallTime * 1000.0);
+	return Result;
+}
+
+void UAssetStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddUObject(this, &UAssetStreamingSubsystem::ReleasePrefetchedAssets);
+}
+
+void UAssetStreamingSubsystem::Deinitialize()
+{
+	FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+	for (TPair<TWeakObjectPtr<const UObject>, FStreamedAssetsEntry>& Entry : Entries)
+	{
+		Entry.Value.Handle->ReleaseHandle();
+	}
+	Entries.Empty();
+	Super::Deinitialize();
+}
+
+void UAssetStreamingSubsystem::RequestAssets(const UObject* Requester, const TArray<FSoftObjectPath>& Assets, EAssetStreamingReason Reason)
+{
+	if (CVarAssetStreamingEnabled.GetValueOnGameThread() == 0 || Assets.Num() == 0)
+	{
+		return;
+	}
+
+	FStreamedAssetsEntry* Entry = Entries.Find(Requester);
+	if (Entry != nullptr)
+	{
+		bool bIsRaisedWhileLoading = Reason > Entry->Reason && Entry->Handle->IsLoadingInProgress();
+		if (Entry->Assets == Assets && !bIsRaisedWhileLoading)
+		{
+			Entry->Reason = Reason;
+			return;
+		}
+
+		// Item prefetched at low priority and equipped before it's loaded would stall on its first use otherwise.
+		// The new handle is requested before the old one is released, so nothing loaded already gets unloaded in between
+		TSharedPtr<FStreamableHandle> Handle = RequestAsyncLoad(Assets, Reason);
+		Entry->Handle->ReleaseHandle();
+		if (!Handle.IsValid())
+		{
+			Entries.Remove(Requester);
+			return;
+		}
+		Entry->Handle = Handle;
+		Entry->Assets = Assets;
+		Entry->Reason = Reason;
+		return;
+	}
+
+	if (Reason == EAssetStreamingReason::Prefetch && IsUnderMemoryPressure())
+	{
+		ReleasePrefetchedAssets();
+		return;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = RequestAsyncLoad(Assets, Reason);
+	if (Handle.IsValid())
+	{
+		FStreamedAssetsEntry& NewEntry = Entries.Add(TWeakObjectPtr<const UObject>(Requester));
+		NewEntry.Handle = Handle;
+		NewEntry.Assets = Assets;
+		NewEntry.Reason = Reason;
+	}
+}
+
+void UAssetStreamingSubsystem::ReleaseAssets(const UObject* Requester)
+{
+	FStreamedAssetsEntry Entry;
+	if (Entries.RemoveAndCopyValue(Requester, Entry))
+	{
+		Entry.Handle->ReleaseHandle();
+	}
+}
+
+void UAssetStreamingSubsystem::ReleasePrefetchedAssets()
+{
+	int32 ReleasedCount = 0;
+	for (TMap<TWeakObjectPtr<const UObject>, FStreamedAssetsEntry>::TIterator EntryIt = Entries.CreateIterator(); EntryIt; ++EntryIt)
+	{
+		// Entries of requesters destroyed without a release go as well
+		if (EntryIt->Value.Reason == EAssetStreamingReason::Prefetch || !EntryIt->Key.IsValid())
+		{
+			EntryIt->Value.Handle->ReleaseHandle();
+			EntryIt.RemoveCurrent();
+			++ReleasedCount;
+		}
+	}
+	UE_LOG(LogAssetStreaming, Verbose, TEXT("Released %d prefetched asset handles"), ReleasedCount);
+}
+
+void UAssetStreamingSubsystem::GCAssetStreamingReport()
+{
+	int32 InUseCount = 0;
+	int32 PrefetchCount = 0;
+	TSet<UObject*> ResidentAssets;
+	TArray<UObject*> LoadedAssets;
+	for (const TPair<TWeakObjectPtr<const UObject>, FStreamedAssetsEntry>& Entry : Entries)
+	{
+		InUseCount += Entry.Value.Reason == EAssetStreamingReason::InUse ? 1 : 0;
+		PrefetchCount += Entry.Value.Reason == EAssetStreamingReason::Prefetch ? 1 : 0;
+
+		LoadedAssets.Reset();
+		Entry.Value.Handle->GetLoadedAssets(LoadedAssets);
+		ResidentAssets.Append(LoadedAssets);
+	}
+
+	SIZE_T ResidentBytes = 0;
+	for (UObject* Asset : ResidentAssets)
+	{
+		ResidentBytes += IsValid(Asset) ? Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : 0;
+	}
+
+	UE_LOG(LogAssetStreaming, Display, TEXT("Asset streaming: %s | handles: %d in use, %d prefetched | resident: %d assets, %.2f MB | used physical: %.2f MB"),
+		CVarAssetStreamingEnabled.GetValueOnGameThread() != 0 ? TEXT("on") : TEXT("off"), InUseCount, PrefetchCount, ResidentAssets.Num(),
+		(double)ResidentBytes / (1024.0 * 1024.0), (double)FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0));
+	UE_LOG(LogAssetStreaming, Display, TEXT("Async loads: %d, average %.3f ms, max %.3f ms | sync load stalls: %d, %.3f ms total"),
+		AsyncLoadsCount, AsyncLoadsCount > 0 ? AsyncLoadTimeSum * 1000.0 / AsyncLoadsCount : 0.0, MaxAsyncLoadTime * 1000.0, SyncLoadStallsCount, SyncLoadStallsTime * 1000.0);
+}
+
+void UAssetStreamingSubsystem::GCAssetStreamingTrim()
+{
+	ReleasePrefetchedAssets();
+}
+
+bool UAssetStreamingSubsystem::IsUnderMemoryPressure() const
+{
+	return FPlatformMemory::GetStats().AvailablePhysical < (uint64)MinAvailablePhysicalMB * 1024 * 1024;
+}
+
+TSharedPtr<FStreamableHandle> UAssetStreamingSubsystem::RequestAsyncLoad(const TArray<FSoftObjectPath>& Assets, EAssetStreamingReason Reason)
+{
+	double RequestTime = FPlatformTime::Seconds();
+	TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(
+		Assets,
+		FStreamableDelegate(),
+		Reason == EAssetStreamingReason::InUse ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority);
+
+	// Assets that are loaded already complete the handle right away, only real loads go to the load time stats
+	if (Handle.IsValid() && !Handle->HasLoadCompleted())
+	{
+		Handle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &UAssetStreamingSubsystem::OnAssetsLoaded, RequestTime));
+	}
+	return Handle;
+}
+
+void UAssetStreamingSubsystem::OnAssetsLoaded(double RequestTime)
+{
+	double LoadTime = FPlatformTime::Seconds() - RequestTime;
+	INC_DWORD_STAT(STAT_AssetStreamingAsyncLoads);
+	CSV_CUSTOM_STAT(GameCode, AssetStreamingLoadMs, (float)(LoadTime * 1000.0), ECsvCustomStatOp::Accumulate);
+
+	++AsyncLoadsCount;
+	AsyncLoadTimeSum += LoadTime;
+	MaxAsyncLoadTime = FMath::Max(MaxAsyncLoadTime, LoadTime);
+}
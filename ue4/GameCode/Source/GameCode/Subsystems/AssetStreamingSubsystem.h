@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "AssetStreamingSubsystem.generated.h"
+
+enum class EAssetStreamingReason : uint8
+{
+	// Might be needed soon, released first under memory pressure
+	Prefetch = 0,
+	InUse
+};
+
+struct FStreamedAssetsEntry
+{
+	TSharedPtr<FStreamableHandle> Handle;
+	TArray<FSoftObjectPath> Assets;
+	EAssetStreamingReason Reason = EAssetStreamingReason::Prefetch;
+};
+
+namespace GCAssetStreaming
+{
+	// Returns the asset if it's streamed in already, otherwise loads it on the game thread and counts the stall
+	GAMECODE_API UObject* GetOrLoadAsset(const FSoftObjectPath& AssetPath);
+
+	template<class TAsset>
+	TAsset* GetOrLoadAsset(const TSoftObjectPtr<TAsset>& Asset)
+	{
+		return Cast<TAsset>(GetOrLoadAsset(Asset.ToSoftObjectPath()));
+	}
+}
+
+/**
+ * Keeps soft referenced assets of equipment streamed in while their requester needs them.
+ * GCAssetStreamingReport logs load times and resident memory of the streamed assets, gc.AssetStreaming.Enabled 0 gives the numbers without streaming
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UAssetStreamingSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Later request of the same requester replaces the earlier one. It's reissued when the assets differ or it's still loading at a lower priority
+	void RequestAssets(const UObject* Requester, const TArray<FSoftObjectPath>& Assets, EAssetStreamingReason Reason);
+	void ReleaseAssets(const UObject* Requester);
+
+	void ReleasePrefetchedAssets();
+
+protected:
+	// Prefetching stops and prefetched assets are released when less physical memory is available
+	UPROPERTY(Config)
+	int32 MinAvailablePhysicalMB = 512;
+
+private:
+	UFUNCTION(exec)
+	void GCAssetStreamingReport();
+
+	UFUNCTION(exec)
+	void GCAssetStreamingTrim();
+
+	bool IsUnderMemoryPressure() const;
+	TSharedPtr<FStreamableHandle> RequestAsyncLoad(const TArray<FSoftObjectPath>& Assets, EAssetStreamingReason Reason);
+	void OnAssetsLoaded(double RequestTime);
+
+	FStreamableManager StreamableManager;
+
+	TMap<TWeakObjectPtr<const UObject>, FStreamedAssetsEntry> Entries;
+
+	int32 AsyncLoadsCount = 0;
+	double AsyncLoadTimeSum = 0.0;
+	double MaxAsyncLoadTime = 0.0;
+
+	FDelegateHandle MemoryTrimHandle;
+};
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CombatSnapshotSubsystem.h"
+#include "AIController.h"
+#include "Actors/Equipment/Weapons/RangeWeaponItem.h"
+#include "AI/Characters/Turret.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Characters/GCBaseCharacter.h"
+#include "Components/CharacterComponents/CharacterAttributesComponent.h"
+#include "Components/CharacterComponents/CharacterEquipmentComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat snapshot combatants"), STAT_CombatSnapshotCombatants, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Combat snapshot build"), STAT_CombatSnapshotBuild, STATGROUP_GameCode);
+
+void FCombatSnapshot::Reset()
+{
+	Pawns.Reset();
+	Locations.Reset();
+	bIsAlive.Reset();
+	Teams.Reset();
+	WeaponStates.Reset();
+	Ammo.Reset();
+	TargetIndices.Reset();
+	Indices.Reset();
+}
+
+void UCombatSnapshotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UCombatSnapshotSubsystem::OnWorldPreActorTick);
+}
+
+void UCombatSnapshotSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	Combatants.Empty();
+	Snapshot.Reset();
+	Super::Deinitialize();
+}
+
+void UCombatSnapshotSubsystem::RegisterCombatant(APawn* Pawn)
+{
+	Combatants.AddUnique(Pawn);
+}
+
+void UCombatSnapshotSubsystem::UnregisterCombatant(APawn* Pawn)
+{
+	Combatants.RemoveSingleSwap(Pawn);
+}
+
+int32 UCombatSnapshotSubsystem::FindIndex(const AActor* Actor) const
+{
+	const int32* Index = Snapshot.Indices.Find(Actor);
+	return Index != nullptr ? *Index : INDEX_NONE;
+}
+
+int32 UCombatSnapshotSubsystem::FindTargetIndex(const AAIController* Controller, FName TargetKeyName) const
+{
+	if (!IsValid(Controller))
+	{
+		return INDEX_NONE;
+	}
+
+	// Current target is captured with the snapshot, other keys still go through the blackboard
+	int32 PawnIndex = FindIndex(Controller->GetPawn());
+	if (TargetKeyName == BB_CurrentTarget && PawnIndex != INDEX_NONE)
+	{
+		return Snapshot.TargetIndices[PawnIndex];
+	}
+
+	const UBlackboardComponent* Blackboard = Controller->GetBlackboardComponent();
+	return IsValid(Blackboard) ? FindIndex(Cast<AActor>(Blackboard->GetValueAsObject(TargetKeyName))) : INDEX_NONE;
+}
+
+void UCombatSnapshotSubsystem::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		BuildSnapshot();
+	}
+}
+
+void UCombatSnapshotSubsystem::BuildSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatSnapshotBuild);
+	CSV_SCOPED_TIMING_STAT(GameCode, CombatSnapshot);
+
+	Snapshot.Reset();
+	CombatantTargets.Reset();
+	for (int32 i = Combatants.Num() - 1; i >= 0; --i)
+	{
+		APawn* Pawn = Combatants[i].Get();
+		if (!IsValid(Pawn))
+		{
+			Combatants.RemoveAtSwap(i);
+			continue;
+		}
+
+		bool bIsAlive = true;
+		ETeams Team = ETeams::Enemy;
+		ECombatWeaponState WeaponState = ECombatWeaponState::None;
+		int32 Ammo = INDEX_NONE;
+		AActor* Target = nullptr;
+
+		AGCBaseCharacter* Character = Cast<AGCBaseCharacter>(Pawn);
+		ATurret* Turret = Cast<ATurret>(Pawn);
+		if (IsValid(Character))
+		{
+			bIsAlive = Character->GetCharacterAttributesComponent()->IsAlive();
+			Team = (ETeams)Character->GetGenericTeamId().GetId();
+
+			const ARangeWeaponItem* RangeWeapon = Character->GetCharacterEquipmentComponent()->GetCurrentRangeWeapon();
+			if (IsValid(RangeWeapon))
+			{
+				WeaponState = RangeWeapon->IsReloading() ? ECombatWeaponState::Reloading : (RangeWeapon->IsFiring() ? ECombatWeaponState::Firing : ECombatWeaponState::Idle);
+				Ammo = RangeWeapon->GetAmmo();
+			}
+
+			const AAIController* AIController = Cast<AAIController>(Character->GetController());
+			const UBlackboardComponent* Blackboard = IsValid(AIController) ? AIController->GetBlackboardComponent() : nullptr;
+			Target = IsValid(Blackboard) ? Cast<AActor>(Blackboard->GetValueAsObject(BB_CurrentTarget)) : nullptr;
+		}
+		else if (IsValid(Turret))
+		{
+			bIsAlive = !Turret->IsDestroyed();
+			Team = Turret->GetTeam();
+			WeaponState = Turret->IsFiring() ? ECombatWeaponState::Firing : ECombatWeaponState::Idle;
+			Target = Turret->GetCurrentTarget();
+		}
+
+		Snapshot.Indices.Add(Pawn, Snapshot.Pawns.Num());
+		Snapshot.Pawns.Add(Pawn);
+		Snapshot.Locations.Add(Pawn->GetActorLocation());
+		Snapshot.bIsAlive.Add(bIsAlive);
+		Snapshot.Teams.Add(Team);
+		Snapshot.WeaponStates.Add(WeaponState);
+		Snapshot.Ammo.Add(Ammo);
+		CombatantTargets.Add(Target);
+	}
+
+	// Targets are resolved once every combatant has its index
+	Snapshot.TargetIndices.SetNumUninitialized(Snapshot.Pawns.Num());
+	for (int32 i = 0; i < Snapshot.Pawns.Num(); ++i)
+	{
+		Snapshot.TargetIndices[i] = FindIndex(CombatantTargets[i]);
+	}
+
+	INC_DWORD_STAT_BY(STAT_CombatSnapshotCombatants, Snapshot.Pawns.Num());
+	CSV_CUSTOM_STAT(GameCode, CombatSnapshotCombatants, Snapshot.Pawns.Num(), ECsvCustomStatOp::Set);
+}
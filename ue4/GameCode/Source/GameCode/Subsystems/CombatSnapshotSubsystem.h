@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameCodeTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatSnapshotSubsystem.generated.h"
+
+class AAIController;
+enum class ECombatWeaponState : uint8
+{
+	None,
+	Idle,
+	Firing,
+	Reloading
+};
+
+/**
+ * Combat state of every registered character and turret, captured once at the start of the frame.
+ * Index of a combatant is valid for the frame only, TargetIndices point into the same arrays
+ */
+struct FCombatSnapshot
+{
+	TArray<APawn*> Pawns;
+	TArray<FVector> Locations;
+	TArray<bool> bIsAlive;
+	TArray<ETeams> Teams;
+	TArray<ECombatWeaponState> WeaponStates;
+
+	// INDEX_NONE for weapons without ammo
+	TArray<int32> Ammo;
+	TArray<int32> TargetIndices;
+
+	TMap<const AActor*, int32> Indices;
+
+	void Reset();
+};
+
+/**
+ * Builds the combat snapshot AI services, tasks and turrets read instead of walking components of every pawn
+ */
+UCLASS()
+class GAMECODE_API UCombatSnapshotSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RegisterCombatant(APawn* Pawn);
+	void UnregisterCombatant(APawn* Pawn);
+
+	const FCombatSnapshot& GetSnapshot() const { return Snapshot; }
+
+	int32 FindIndex(const AActor* Actor) const;
+
+	// Snapshot index of the target an AI controller keeps in its blackboard, INDEX_NONE if the target isn't a combatant
+	int32 FindTargetIndex(const AAIController* Controller, FName TargetKeyName) const;
+
+private:
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void BuildSnapshot();
+
+	TArray<TWeakObjectPtr<APawn>> Combatants;
+	TArray<AActor*> CombatantTargets;
+
+	FCombatSnapshot Snapshot;
+
+	FDelegateHandle PreActorTickHandle;
+};
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DamageSubsystem.h"
+#include "GameCodeTypes.h"
+#include "AI/Characters/Turret.h"
+#include "AI/Controllers/GCAIController.h"
+#include "Characters/GCBaseCharacter.h"
+#include "Components/CharacterComponents/CharacterAttributesComponent.h"
+#include "Perception/AISense_Damage.h"
+#include "Utils/GCTelemetry.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage hits"), STAT_DamageHits, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage victims"), STAT_DamageVictims, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage kills"), STAT_DamageKills, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Damage apply"), STAT_DamageApply, STATGROUP_GameCode);
+
+void UDamageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UDamageSubsystem::OnWorldPostActorTick);
+}
+
+void UDamageSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingDamage.Empty();
+	ApplyingDamage.Empty();
+	PendingDamageIndices.Empty();
+	Super::Deinitialize();
+}
+
+void UDamageSubsystem::SubmitDamage(AActor* Victim, float Amount, AController* Instigator, AActor* Causer)
+{
+	if (!IsValid(Victim) || Amount <= 0.0f)
+	{
+		return;
+	}
+
+	int32* DamageIndex = PendingDamageIndices.Find(Victim);
+	FAggregatedDamage& Damage = DamageIndex != nullptr ? PendingDamage[*DamageIndex] : PendingDamage.AddDefaulted_GetRef();
+	if (DamageIndex == nullptr)
+	{
+		PendingDamageIndices.Add(Victim, PendingDamage.Num() - 1);
+		Damage.Victim = Victim;
+	}
+
+	Damage.Instigator = Instigator;
+	Damage.Causer = Causer;
+	Damage.CauserLocation = IsValid(Causer) ? Causer->GetActorLocation() : Victim->GetActorLocation();
+	Damage.Amount += Amount;
+	++Damage.HitsCount;
+	++PendingHitsCount;
+}
+
+void UDamageSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && PendingDamage.Num() > 0)
+	{
+		ApplyPendingDamage();
+	}
+}
+
+void UDamageSubsystem::ApplyPendingDamage()
+{
+	SCOPE_CYCLE_COUNTER(STAT_DamageApply);
+	CSV_SCOPED_TIMING_STAT(GameCode, Damage);
+
+	// Deaths may deal damage again, that damage is collected for the next frame.
+	// Both buffers keep their capacity, the one applied last frame collects new damage
+	Swap(ApplyingDamage, PendingDamage);
+	PendingDamageIndices.Reset();
+	int32 HitsCount = PendingHitsCount;
+	PendingHitsCount = 0;
+
+	int32 KillsCount = 0;
+	for (const FAggregatedDamage& Damage : ApplyingDamage)
+	{
+		AActor* Victim = Damage.Victim.Get();
+		if (!IsValid(Victim))
+		{
+			continue;
+		}
+
+		bool bWasAlive = IsVictimAlive(Victim);
+		Victim->TakeDamage(Damage.Amount, FDamageEvent(), Damage.Instigator.Get(), Damage.Causer.Get());
+		bool bIsKilled = bWasAlive && !IsVictimAlive(Victim);
+		KillsCount += bIsKilled ? 1 : 0;
+
+		GCTelemetry::RecordEvent(ETelemetryEventType::Damage, Damage.Causer.Get(), Victim, Damage.Amount, Victim->GetActorLocation());
+		if (bIsKilled)
+		{
+			GCTelemetry::RecordEvent(ETelemetryEventType::Death, Damage.Causer.Get(), Victim, Damage.Amount, Victim->GetActorLocation());
+		}
+
+		// Only AI listens to the damage sense
+		APawn* VictimPawn = Cast<APawn>(Victim);
+		if (IsValid(VictimPawn) && VictimPawn->GetController() != nullptr && VictimPawn->GetController()->IsA<AGCAIController>())
+		{
+			UAISense_Damage::ReportDamageEvent(GetWorld(), Victim, Damage.Causer.Get(), Damage.Amount, Damage.CauserLocation, Victim->GetActorLocation());
+		}
+
+		UE_LOG(LogDamage, Verbose, TEXT("%s took %.2f damage in %d hits from %s%s"),
+			*Victim->GetName(), Damage.Amount, Damage.HitsCount, *GetNameSafe(Damage.Causer.Get()), bIsKilled ? TEXT(", killed") : TEXT(""));
+	}
+
+	INC_DWORD_STAT_BY(STAT_DamageHits, HitsCount);
+	INC_DWORD_STAT_BY(STAT_DamageVictims, ApplyingDamage.Num());
+	INC_DWORD_STAT_BY(STAT_DamageKills, KillsCount);
+	CSV_CUSTOM_STAT(GameCode, DamageHits, HitsCount, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(GameCode, DamageVictims, ApplyingDamage.Num(), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(GameCode, DamageKills, KillsCount, ECsvCustomStatOp::Accumulate);
+
+	ApplyingDamage.Reset();
+}
+
+bool UDamageSubsystem::IsVictimAlive(const AActor* Victim)
+{
+	const AGCBaseCharacter* Character = Cast<AGCBaseCharacter>(Victim);
+	if (IsValid(Character))
+	{
+		return Character->GetCharacterAttributesComponent()->IsAlive();
+	}
+
+	const ATurret* Turret = Cast<ATurret>(Victim);
+	if (IsValid(Turret))
+	{
+		return !Turret->IsDestroyed();
+	}
+	return true;
+}
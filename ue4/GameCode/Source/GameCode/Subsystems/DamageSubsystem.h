@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DamageSubsystem.generated.h"
+
+/**
+ * Hits of one victim in a frame, instigator and causer are the ones of the latest hit
+ */
+struct FAggregatedDamage
+{
+	TWeakObjectPtr<AActor> Victim;
+	TWeakObjectPtr<AController> Instigator;
+	TWeakObjectPtr<AActor> Causer;
+	FVector CauserLocation = FVector::ZeroVector;
+	float Amount = 0.0f;
+	int32 HitsCount = 0;
+};
+
+/**
+ * Collects damage dealt during a frame and applies it after actors have ticked, one TakeDamage per victim in order of the first hit.
+ * Damage submitted while the batch is applied goes to the next frame
+ */
+UCLASS()
+class GAMECODE_API UDamageSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void SubmitDamage(AActor* Victim, float Amount, AController* Instigator, AActor* Causer);
+
+private:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void ApplyPendingDamage();
+	static bool IsVictimAlive(const AActor* Victim);
+
+	TArray<FAggregatedDamage> PendingDamage;
+	TArray<FAggregatedDamage> ApplyingDamage;
+	TMap<TWeakObjectPtr<AActor>, int32> PendingDamageIndices;
+	int32 PendingHitsCount = 0;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -14,4 +14,5 @@ void UDebugSubsystem::EnableDebugCategory(const FName& CategoryName, bool bIsEna
 {
 	EnabledDebugCategories.FindOrAdd(CategoryName);
 	EnabledDebugCategories[CategoryName] = bIsEnabled;
+	OnDebugCategoryChanged.Broadcast(CategoryName, bIsEnabled);
 }
@@ -6,6 +6,8 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "DebugSubsystem.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnDebugCategoryChangedSignature, const FName&, bool);
+
 /**
  * 
  */
@@ -17,6 +19,8 @@ class GAMECODE_API UDebugSubsystem : public UGameInstanceSubsystem
 public:
 	bool IsCategoryEnabled(const FName& CategoryName) const;
 
+	FOnDebugCategoryChangedSignature OnDebugCategoryChanged;
+
 private:
 
 	UFUNCTION(exec)
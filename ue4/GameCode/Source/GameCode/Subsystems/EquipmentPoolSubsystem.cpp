@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EquipmentPoolSubsystem.h"
+#include "GameCodeTypes.h"
+#include "Actors/Equipment/EquipableItem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Equipment items reused"), STAT_EquipmentItemsReused, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Equipment items spawned"), STAT_EquipmentItemsSpawned, STATGROUP_GameCode);
+
+static TAutoConsoleVariable<int32> CVarEquipmentPoolEnabled(
+	TEXT("gc.EquipmentPool.Enabled"),
+	1,
+	TEXT("Equipment items are returned to a pool on death or despawn of their owner instead of being destroyed"),
+	ECVF_Default);
+
+void UEquipmentPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UEquipmentPoolSubsystem::OnWorldInitializedActors);
+}
+
+void UEquipmentPoolSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+	// Pooled items are level actors, they go away with the world
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+AEquipableItem* UEquipmentPoolSubsystem::AcquireItem(TSubclassOf<AEquipableItem> ItemClass, AActor* NewOwner)
+{
+	FEquipmentItemPool* Pool = Pools.Find(ItemClass);
+	while (Pool != nullptr && Pool->Items.Num() > 0)
+	{
+		AEquipableItem* Item = Pool->Items.Pop(false);
+		if (IsValid(Item))
+		{
+			INC_DWORD_STAT(STAT_EquipmentItemsReused);
+			Item->OnTakenFromPool(NewOwner);
+			return Item;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_EquipmentItemsSpawned);
+	return SpawnItem(ItemClass, NewOwner);
+}
+
+void UEquipmentPoolSubsystem::ReleaseItem(AEquipableItem* Item)
+{
+	if (!IsValid(Item))
+	{
+		return;
+	}
+
+	FEquipmentItemPool& Pool = Pools.FindOrAdd(Item->GetClass());
+	if (CVarEquipmentPoolEnabled.GetValueOnGameThread() == 0 || Pool.Items.Num() >= MaxPooledItemsPerClass)
+	{
+		Item->Destroy();
+		return;
+	}
+
+	Item->OnReturnedToPool();
+	Pool.Items.Add(Item);
+}
+
+void UEquipmentPoolSubsystem::PrewarmItems(TSubclassOf<AEquipableItem> ItemClass, int32 Count)
+{
+	if (!IsValid(ItemClass) || CVarEquipmentPoolEnabled.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	FEquipmentItemPool& Pool = Pools.FindOrAdd(ItemClass);
+	int32 TargetCount = FMath::Min(Count, MaxPooledItemsPerClass);
+	Pool.Items.Reserve(TargetCount);
+	while (Pool.Items.Num() < TargetCount)
+	{
+		AEquipableItem* Item = SpawnItem(ItemClass, nullptr);
+		if (!IsValid(Item))
+		{
+			break;
+		}
+		Item->OnReturnedToPool();
+		Pool.Items.Add(Item);
+	}
+}
+
+int32 UEquipmentPoolSubsystem::GetPooledItemsCount() const
+{
+	int32 Result = 0;
+	for (const TPair<UClass*, FEquipmentItemPool>& Pool : Pools)
+	{
+		Result += Pool.Value.Items.Num();
+	}
+	return Result;
+}
+
+void UEquipmentPoolSubsystem::OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params)
+{
+	if (Params.World != GetWorld())
+	{
+		return;
+	}
+
+	for (const FEquipmentPoolPrewarm& Prewarm : PrewarmedItems)
+	{
+		if (!Prewarm.ItemClass.IsNull())
+		{
+			PrewarmItems(Prewarm.ItemClass.LoadSynchronous(), Prewarm.Count);
+		}
+	}
+}
+
+AEquipableItem* UEquipmentPoolSubsystem::SpawnItem(TSubclassOf<AEquipableItem> ItemClass, AActor* NewOwner)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = NewOwner;
+	return GetWorld()->SpawnActor<AEquipableItem>(ItemClass, FTransform::Identity, SpawnParameters);
+}
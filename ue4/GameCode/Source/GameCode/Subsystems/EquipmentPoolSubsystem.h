@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EquipmentPoolSubsystem.generated.h"
+
+class AEquipableItem;
+
+USTRUCT()
+struct FEquipmentItemPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEquipableItem*> Items;
+};
+
+USTRUCT()
+struct FEquipmentPoolPrewarm
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	TSoftClassPtr<AEquipableItem> ItemClass;
+
+	UPROPERTY(Config)
+	int32 Count = 0;
+};
+
+/**
+ * Keeps hidden equipment items by class, so loadouts of spawned characters don't construct and register new actors.
+ * Items are returned on death or despawn of their owner and reset by AEquipableItem::OnReturnedToPool
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UEquipmentPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	AEquipableItem* AcquireItem(TSubclassOf<AEquipableItem> ItemClass, AActor* NewOwner);
+	void ReleaseItem(AEquipableItem* Item);
+
+	void PrewarmItems(TSubclassOf<AEquipableItem> ItemClass, int32 Count);
+
+	int32 GetPooledItemsCount() const;
+
+protected:
+	// Spawned once the level actors are initialized, e.g. +PrewarmedItems=(ItemClass=/Game/Weapons/BP_Rifle.BP_Rifle_C,Count=40)
+	UPROPERTY(Config)
+	TArray<FEquipmentPoolPrewarm> PrewarmedItems;
+
+	// Items returned above this amount are destroyed
+	UPROPERTY(Config)
+	int32 MaxPooledItemsPerClass = 64;
+
+private:
+	void OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params);
+
+	AEquipableItem* SpawnItem(TSubclassOf<AEquipableItem> ItemClass, AActor* NewOwner);
+
+	UPROPERTY()
+	TMap<UClass*, FEquipmentItemPool> Pools;
+
+	FDelegateHandle WorldInitializedActorsHandle;
+};
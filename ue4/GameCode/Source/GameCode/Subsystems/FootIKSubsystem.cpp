@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FootIKSubsystem.h"
+#include "GameCodeTypes.h"
+#include "DrawDebugHelpers.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Subsystems/DebugSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Foot IK probes traced"), STAT_FootIKProbesTraced, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Foot IK agents skipped as stationary"), STAT_FootIKAgentsStationary, STATGROUP_GameCode);
+
+void UFootIKSubsystem::Deinitialize()
+{
+	Agents.Empty();
+	Super::Deinitialize();
+}
+
+void UFootIKSubsystem::Tick(float DeltaTime)
+{
+	if (Agents.Num() == 0)
+	{
+		return;
+	}
+
+	CSV_SCOPED_TIMING_STAT(GameCode, FootIK);
+
+#if ENABLE_DRAW_DEBUG
+	UDebugSubsystem* DebugSubSystem = UGameplayStatics::GetGameInstance(GetWorld())->GetSubsystem<UDebugSubsystem>();
+	bool bIsDebugEnabled = DebugSubSystem->IsCategoryEnabled(DebugCategoryFootIK);
+#else
+	bool bIsDebugEnabled = false;
+#endif
+
+	FVector ViewLocation = FVector::ZeroVector;
+	bool bHasViewLocation = false;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (IsValid(PlayerController) && IsValid(PlayerController->PlayerCameraManager))
+	{
+		ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+		bHasViewLocation = true;
+	}
+
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+	int32 ProbesBudget = MaxProbesPerFrame;
+	int32 MaxIndex = Agents.GetMaxIndex();
+	for (int32 i = 0; i < MaxIndex && ProbesBudget > 0; ++i)
+	{
+		if (NextAgentIndex >= MaxIndex)
+		{
+			NextAgentIndex = 0;
+		}
+		int32 AgentId = NextAgentIndex++;
+		if (!Agents.IsAllocated(AgentId))
+		{
+			continue;
+		}
+
+		FFootIKAgent& Agent = Agents[AgentId];
+		APawn* Pawn = Agent.Pawn.Get();
+		if (!IsValid(Pawn) || !Agent.Mesh.IsValid() || Agent.NextUpdateTime > CurrentTime)
+		{
+			continue;
+		}
+
+		const FTransform& ActorTransform = Pawn->GetActorTransform();
+		Agent.NextUpdateTime = CurrentTime + FMath::Max(Agent.MinUpdateInterval, GetUpdateInterval(ActorTransform.GetLocation(), bHasViewLocation ? &ViewLocation : nullptr));
+
+		ACharacter* Character = Cast<ACharacter>(Pawn);
+		UPrimitiveComponent* Floor = IsValid(Character) ? Character->GetMovementBase() : nullptr;
+		if (Agent.bHasBeenProbed && Floor == Agent.LastProbedFloor.Get() && ActorTransform.Equals(Agent.LastProbedTransform, StationaryTolerance))
+		{
+			INC_DWORD_STAT(STAT_FootIKAgentsStationary);
+			continue;
+		}
+
+		Agent.bHasBeenProbed = true;
+		Agent.LastProbedTransform = ActorTransform;
+		Agent.LastProbedFloor = Floor;
+		ProbesBudget -= ProbeAgent(Agent, bIsDebugEnabled);
+	}
+}
+
+TStatId UFootIKSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootIKSubsystem, STATGROUP_GameCode);
+}
+
+int32 UFootIKSubsystem::RegisterAgent(APawn* Pawn, USkeletalMeshComponent* Mesh, const TArray<FName>& SocketNames, const FFootIKProbeSettings& Settings)
+{
+	FFootIKAgent Agent;
+	Agent.Pawn = Pawn;
+	Agent.Mesh = Mesh;
+	ACharacter* Character = Cast<ACharacter>(Pawn);
+	if (IsValid(Character))
+	{
+		Agent.Capsule = Character->GetCapsuleComponent();
+	}
+
+	Agent.SocketNames.Append(SocketNames);
+	Agent.Offsets.SetNumZeroed(SocketNames.Num());
+	Agent.Settings = Settings;
+	Agent.ProbeShape = Settings.BoxExtent.IsNearlyZero() ? FCollisionShape() : FCollisionShape::MakeBox(Settings.BoxExtent);
+
+	Agent.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(FootIKProbe), true, Pawn);
+	return Agents.Add(MoveTemp(Agent));
+}
+
+void UFootIKSubsystem::UnregisterAgent(int32 AgentId)
+{
+	if (Agents.IsValidIndex(AgentId))
+	{
+		Agents.RemoveAt(AgentId);
+	}
+}
+
+void UFootIKSubsystem::SetAgentMinUpdateInterval(int32 AgentId, float MinUpdateInterval)
+{
+	if (Agents.IsValidIndex(AgentId))
+	{
+		Agents[AgentId].MinUpdateInterval = MinUpdateInterval;
+	}
+}
+
+float UFootIKSubsystem::GetFootOffset(int32 AgentId, int32 ProbeIndex) const
+{
+	if (!Agents.IsValidIndex(AgentId) || !Agents[AgentId].Offsets.IsValidIndex(ProbeIndex))
+	{
+		return 0.0f;
+	}
+	return Agents[AgentId].Offsets[ProbeIndex];
+}
+
+float UFootIKSubsystem::GetUpdateInterval(const FVector& AgentLocation, const FVector* ViewLocation) const
+{
+	if (ViewLocation == nullptr)
+	{
+		return 0.0f;
+	}
+
+	float Distance = FVector::Dist(AgentLocation, *ViewLocation);
+	float Alpha = FMath::GetRangePct(NearDistance, FarDistance, Distance);
+	return FMath::Lerp(0.0f, FarUpdateInterval, FMath::Clamp(Alpha, 0.0f, 1.0f));
+}
+
+int32 UFootIKSubsystem::ProbeAgent(FFootIKAgent& Agent, bool bIsDebugEnabled)
+{
+	UWorld* World = GetWorld();
+	USkeletalMeshComponent* Mesh = Agent.Mesh.Get();
+	FVector ActorLocation = Agent.LastProbedTransform.GetLocation();
+
+	float CapsuleHalfHeight = Agent.Capsule.IsValid() ? Agent.Capsule->GetScaledCapsuleHalfHeight() : 0.0f;
+	float TraceLength = Agent.Settings.TraceLength + CapsuleHalfHeight;
+	float ReferenceOffset = Agent.Settings.ReferenceOffset + CapsuleHalfHeight;
+
+	for (int32 i = 0; i < Agent.SocketNames.Num(); ++i)
+	{
+		FTransform SocketTransform = Mesh->GetSocketTransform(Agent.SocketNames[i]);
+		FVector TraceStart(SocketTransform.GetLocation().X, SocketTransform.GetLocation().Y, ActorLocation.Z);
+		FVector TraceEnd = TraceStart - TraceLength * FVector::UpVector;
+
+		FHitResult HitResult;
+		bool bHit = Agent.ProbeShape.IsLine()
+			? World->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_Visibility, Agent.QueryParams)
+			: World->SweepSingleByChannel(HitResult, TraceStart, TraceEnd, SocketTransform.GetRotation(), ECC_Visibility, Agent.ProbeShape, Agent.QueryParams);
+
+		Agent.Offsets[i] = bHit ? (TraceStart.Z - ReferenceOffset - HitResult.Location.Z) / Agent.Settings.Scale : 0.0f;
+
+#if ENABLE_DRAW_DEBUG
+		if (bIsDebugEnabled)
+		{
+			DrawDebugLine(World, TraceStart, bHit ? HitResult.Location : TraceEnd, bHit ? FColor::Green : FColor::Red, false, 0.1f);
+		}
+#endif
+	}
+
+	INC_DWORD_STAT_BY(STAT_FootIKProbesTraced, Agent.SocketNames.Num());
+	CSV_CUSTOM_STAT(GameCode, FootIKTraces, Agent.SocketNames.Num(), ECsvCustomStatOp::Accumulate);
+	return Agent.SocketNames.Num();
+}
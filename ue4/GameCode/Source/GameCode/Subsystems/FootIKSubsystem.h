@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GCTickableWorldSubsystem.h"
+#include "FootIKSubsystem.generated.h"
+
+/**
+ * Probe goes down from the socket projected on the actor location height.
+ * Offset = (TraceStart.Z - ReferenceOffset - Hit.Z) / Scale. When owner is a character, capsule half height is added to TraceLength and ReferenceOffset
+ */
+struct FFootIKProbeSettings
+{
+	float TraceLength = 0.0f;
+	float ReferenceOffset = 0.0f;
+	FVector BoxExtent = FVector::ZeroVector;
+	float Scale = 1.0f;
+};
+
+class USkeletalMeshComponent;
+class UCapsuleComponent;
+struct FFootIKAgent
+{
+	TWeakObjectPtr<APawn> Pawn;
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+	TWeakObjectPtr<UCapsuleComponent> Capsule;
+
+	TArray<FName, TInlineAllocator<4>> SocketNames;
+	TArray<float, TInlineAllocator<4>> Offsets;
+
+	FFootIKProbeSettings Settings;
+	FCollisionShape ProbeShape;
+	FCollisionQueryParams QueryParams;
+
+	bool bHasBeenProbed = false;
+	FTransform LastProbedTransform = FTransform::Identity;
+	TWeakObjectPtr<UPrimitiveComponent> LastProbedFloor;
+	float NextUpdateTime = 0.0f;
+	float MinUpdateInterval = 0.0f;
+};
+
+/**
+ * Traces foot IK probes of every registered pawn from one frame-sliced queue
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UFootIKSubsystem : public UGCTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	int32 RegisterAgent(APawn* Pawn, USkeletalMeshComponent* Mesh, const TArray<FName>& SocketNames, const FFootIKProbeSettings& Settings);
+	void UnregisterAgent(int32 AgentId);
+	void SetAgentMinUpdateInterval(int32 AgentId, float MinUpdateInterval);
+
+	float GetFootOffset(int32 AgentId, int32 ProbeIndex) const;
+
+protected:
+	UPROPERTY(Config)
+	int32 MaxProbesPerFrame = 32;
+
+	// Agents closer to the camera are probed every frame, further ones are probed less often up to FarUpdateInterval
+	UPROPERTY(Config)
+	float NearDistance = 1500.0f;
+
+	UPROPERTY(Config)
+	float FarDistance = 6000.0f;
+
+	UPROPERTY(Config)
+	float FarUpdateInterval = 0.25f;
+
+	UPROPERTY(Config)
+	float StationaryTolerance = 0.1f;
+
+private:
+	float GetUpdateInterval(const FVector& AgentLocation, const FVector* ViewLocation) const;
+	int32 ProbeAgent(FFootIKAgent& Agent, bool bIsDebugEnabled);
+
+	TSparseArray<FFootIKAgent> Agents;
+	int32 NextAgentIndex = 0;
+};
@@ -0,0 +1,316 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GCBenchmarkSubsystem.h"
+#include "BasePlatform.h"
+#include "GameCodeTypes.h"
+#include "AI/Characters/GCAICharacter.h"
+#include "AI/Characters/Turret.h"
+#include "Subsystems/DamageSubsystem.h"
+#include "Subsystems/EquipmentPoolSubsystem.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGCBenchmark, Display, Display)
+
+// Way above the health of any character, waves are killed in one hit
+static const float WaveLethalDamage = 1.0e6f;
+
+void UGCBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UGCBenchmarkSubsystem::OnWorldPostActorTick);
+}
+
+void UGCBenchmarkSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	SpawnedActors.Empty();
+	Super::Deinitialize();
+}
+
+void UGCBenchmarkSubsystem::GCBenchmark(int32 AICharactersCount /*= 32*/, int32 TurretsCount /*= 8*/, int32 PlatformsCount /*= 16*/, int32 FramesCount /*= 600*/, bool bQuitWhenDone /*= false*/)
+{
+	if (bIsRunning || bIsRunningWaves || bIsWaitingForCapture)
+	{
+		UE_LOG(LogGCBenchmark, Warning, TEXT("Benchmark is already running"));
+		return;
+	}
+	if (FramesCount <= 0)
+	{
+		UE_LOG(LogGCBenchmark, Warning, TEXT("Benchmark needs a positive amount of frames"));
+		return;
+	}
+
+	UClass* LoadedAICharacterClass = AICharacterClass.IsNull() ? AGCAICharacter::StaticClass() : AICharacterClass.LoadSynchronous();
+	UClass* LoadedTurretClass = TurretClass.IsNull() ? ATurret::StaticClass() : TurretClass.LoadSynchronous();
+	UClass* LoadedPlatformClass = PlatformClass.IsNull() ? ABasePlatform::StaticClass() : PlatformClass.LoadSynchronous();
+
+	int32 SpawnIndex = 0;
+	SpawnBenchmarkActors(LoadedAICharacterClass, AICharactersCount, SpawnIndex);
+	SpawnBenchmarkActors(LoadedTurretClass, TurretsCount, SpawnIndex);
+	SpawnBenchmarkActors(LoadedPlatformClass, PlatformsCount, SpawnIndex);
+
+	FramesLeft = FramesCount;
+	FramesRecorded = 0;
+	FrameTimeSum = 0.0;
+	StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	LastUsedPhysical = StartUsedPhysical;
+	bQuitOnFinish = bQuitWhenDone;
+	bIsOverBudget = false;
+	bIsRunning = true;
+
+#if CSV_PROFILER
+	FString FileName = FString::Printf(TEXT("GCBenchmark_%dAI_%dTurrets_%dPlatforms_%s.csv"), AICharactersCount, TurretsCount, PlatformsCount, *FDateTime::Now().ToString());
+	FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("GCBenchmark"), FileName);
+#endif
+
+	UE_LOG(LogGCBenchmark, Display, TEXT("Benchmark started | %d AI characters, %d turrets, %d platforms, %d frames"), AICharactersCount, TurretsCount, PlatformsCount, FramesCount);
+}
+
+void UGCBenchmarkSubsystem::GCWavesBenchmark(int32 WavesCount /*= 10*/, int32 WaveSize /*= 40*/, int32 FramesPerWave /*= 90*/, bool bQuitWhenDone /*= false*/)
+{
+	if (bIsRunning || bIsRunningWaves || bIsWaitingForCapture)
+	{
+		UE_LOG(LogGCBenchmark, Warning, TEXT("Benchmark is already running"));
+		return;
+	}
+	if (WavesCount <= 0 || WaveSize <= 0 || FramesPerWave < 2)
+	{
+		UE_LOG(LogGCBenchmark, Warning, TEXT("Waves benchmark needs a positive amount of waves and characters and at least 2 frames per wave"));
+		return;
+	}
+
+	WaveActorClass = AICharacterClass.IsNull() ? AGCAICharacter::StaticClass() : AICharacterClass.LoadSynchronous();
+	WavesLeft = WavesCount;
+	WaveCharactersCount = WaveSize;
+	WaveFramesCount = FramesPerWave;
+	WaveIndex = 0;
+	WaveSpawnTimeSum = 0.0;
+	WaveDespawnTimeSum = 0.0;
+	WorstWaveFrameTime = 0.0;
+	bQuitOnFinish = bQuitWhenDone;
+	bIsOverBudget = false;
+	bIsRunningWaves = true;
+
+	IConsoleVariable* EquipmentPoolCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.EquipmentPool.Enabled"));
+	const bool bIsPoolEnabled = EquipmentPoolCVar != nullptr && EquipmentPoolCVar->GetInt() != 0;
+
+#if CSV_PROFILER
+	FString FileName = FString::Printf(TEXT("GCWaves_%dx%d_Pool%d_%s.csv"), WavesCount, WaveSize, bIsPoolEnabled ? 1 : 0, *FDateTime::Now().ToString());
+	FCsvProfiler::Get()->BeginCapture(-1, FPaths::ProfilingDir() / TEXT("GCBenchmark"), FileName);
+#endif
+
+	UE_LOG(LogGCBenchmark, Display, TEXT("Waves benchmark started | %d waves of %d AI characters, %d frames each | equipment pool: %s"), WavesCount, WaveSize, FramesPerWave, bIsPoolEnabled ? TEXT("on") : TEXT("off"));
+	StartWave();
+}
+
+void UGCBenchmarkSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	if (bIsWaitingForCapture)
+	{
+#if CSV_PROFILER
+		if (FCsvProfiler::Get()->IsWritingFile())
+		{
+			return;
+		}
+#endif
+		bIsWaitingForCapture = false;
+		if (bQuitOnFinish)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, bIsOverBudget ? 1 : 0);
+		}
+		return;
+	}
+
+	if (bIsRunningWaves)
+	{
+		UpdateWave();
+		return;
+	}
+
+	if (!bIsRunning)
+	{
+		return;
+	}
+
+	// Physical memory delta is the closest per frame allocation figure available without a malloc profiler build
+	uint64 UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	CSV_CUSTOM_STAT(GameCode, UsedPhysicalMB, (float)((double)UsedPhysical / (1024.0 * 1024.0)), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(GameCode, AllocatedMB, (float)(((double)UsedPhysical - (double)LastUsedPhysical) / (1024.0 * 1024.0)), ECsvCustomStatOp::Set);
+	LastUsedPhysical = UsedPhysical;
+
+	int32 AliveActorsCount = 0;
+	for (const TWeakObjectPtr<AActor>& SpawnedActor : SpawnedActors)
+	{
+		AliveActorsCount += SpawnedActor.IsValid() ? 1 : 0;
+	}
+	CSV_CUSTOM_STAT(GameCode, BenchmarkActors, AliveActorsCount, ECsvCustomStatOp::Set);
+
+	FrameTimeSum += FApp::GetDeltaTime();
+	++FramesRecorded;
+	if (--FramesLeft <= 0)
+	{
+		FinishBenchmark();
+	}
+}
+
+void UGCBenchmarkSubsystem::SpawnBenchmarkActors(UClass* ActorClass, int32 Count, int32& SpawnIndex)
+{
+	if (!IsValid(ActorClass))
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	const int32 RowLength = 16;
+	for (int32 i = 0; i < Count; ++i, ++SpawnIndex)
+	{
+		FVector Location = SpawnOrigin + FVector((SpawnIndex % RowLength) * SpawnSpacing, (SpawnIndex / RowLength) * SpawnSpacing, 0.0f);
+		AActor* SpawnedActor = GetWorld()->SpawnActor<AActor>(ActorClass, Location, FRotator::ZeroRotator, SpawnParameters);
+		if (!IsValid(SpawnedActor))
+		{
+			continue;
+		}
+
+		APawn* SpawnedPawn = Cast<APawn>(SpawnedActor);
+		if (IsValid(SpawnedPawn) && !IsValid(SpawnedPawn->GetController()))
+		{
+			SpawnedPawn->SpawnDefaultController();
+		}
+		SpawnedActors.Add(SpawnedActor);
+	}
+}
+
+void UGCBenchmarkSubsystem::DestroySpawnedActors()
+{
+	for (const TWeakObjectPtr<AActor>& SpawnedActor : SpawnedActors)
+	{
+		if (SpawnedActor.IsValid())
+		{
+			APawn* SpawnedPawn = Cast<APawn>(SpawnedActor.Get());
+			if (IsValid(SpawnedPawn) && IsValid(SpawnedPawn->GetController()))
+			{
+				SpawnedPawn->GetController()->Destroy();
+			}
+			SpawnedActor->Destroy();
+		}
+	}
+	SpawnedActors.Reset();
+}
+
+void UGCBenchmarkSubsystem::FinishBenchmark()
+{
+	bIsRunning = false;
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->EndCapture();
+#endif
+
+	DestroySpawnedActors();
+
+	double AverageFrameTime = FramesRecorded > 0 ? FrameTimeSum / FramesRecorded : 0.0;
+	double AllocatedMB = ((double)LastUsedPhysical - (double)StartUsedPhysical) / (1024.0 * 1024.0);
+	UE_LOG(LogGCBenchmark, Display, TEXT("Benchmark finished | %d frames | average frame time: %.3f ms | allocated: %.2f MB | capture: %s"),
+		FramesRecorded, AverageFrameTime * 1000.0, AllocatedMB, *(FPaths::ProfilingDir() / TEXT("GCBenchmark")));
+
+	CheckBudget(TEXT("Average frame time, ms"), AverageFrameTime * 1000.0, AverageFrameTimeBudgetMs);
+	CheckBudget(TEXT("Allocated, MB"), AllocatedMB, AllocationBudgetMB);
+
+	bIsWaitingForCapture = true;
+}
+
+void UGCBenchmarkSubsystem::CheckBudget(const TCHAR* BudgetName, double Value, float Budget)
+{
+	if (Budget > 0.0f && Value > Budget)
+	{
+		UE_LOG(LogGCBenchmark, Error, TEXT("Over budget | %s: %.3f, budget: %.3f"), BudgetName, Value, Budget);
+		bIsOverBudget = true;
+	}
+}
+
+void UGCBenchmarkSubsystem::StartWave()
+{
+	int32 SpawnIndex = 0;
+	double SpawnStartTime = FPlatformTime::Seconds();
+	SpawnBenchmarkActors(WaveActorClass, WaveCharactersCount, SpawnIndex);
+	WaveSpawnTime = FPlatformTime::Seconds() - SpawnStartTime;
+	CSV_CUSTOM_STAT(GameCode, WaveSpawnMs, (float)(WaveSpawnTime * 1000.0), ECsvCustomStatOp::Set);
+
+	WaveFrame = 0;
+	WaveMaxFrameTime = 0.0;
+}
+
+void UGCBenchmarkSubsystem::UpdateWave()
+{
+	// Delta time of the frame after a spawn, kill or despawn includes the hitch of it
+	WaveMaxFrameTime = FMath::Max(WaveMaxFrameTime, FApp::GetDeltaTime());
+	CSV_CUSTOM_STAT(GameCode, BenchmarkActors, SpawnedActors.Num(), ECsvCustomStatOp::Set);
+
+	if (++WaveFrame == WaveFramesCount / 2)
+	{
+		KillWave();
+	}
+	if (WaveFrame < WaveFramesCount)
+	{
+		return;
+	}
+
+	double DespawnStartTime = FPlatformTime::Seconds();
+	DestroySpawnedActors();
+	double DespawnTime = FPlatformTime::Seconds() - DespawnStartTime;
+	CSV_CUSTOM_STAT(GameCode, WaveDespawnMs, (float)(DespawnTime * 1000.0), ECsvCustomStatOp::Set);
+
+	UE_LOG(LogGCBenchmark, Display, TEXT("Wave %d | spawn: %.3f ms | despawn: %.3f ms | worst frame: %.3f ms | pooled items: %d"),
+		WaveIndex, WaveSpawnTime * 1000.0, DespawnTime * 1000.0, WaveMaxFrameTime * 1000.0, GetWorld()->GetSubsystem<UEquipmentPoolSubsystem>()->GetPooledItemsCount());
+
+	WaveSpawnTimeSum += WaveSpawnTime;
+	WaveDespawnTimeSum += DespawnTime;
+	WorstWaveFrameTime = FMath::Max(WorstWaveFrameTime, WaveMaxFrameTime);
+	++WaveIndex;
+
+	if (--WavesLeft <= 0)
+	{
+		FinishWaves();
+	}
+	else
+	{
+		StartWave();
+	}
+}
+
+void UGCBenchmarkSubsystem::KillWave()
+{
+	UDamageSubsystem* DamageSubsystem = GetWorld()->GetSubsystem<UDamageSubsystem>();
+	for (const TWeakObjectPtr<AActor>& SpawnedActor : SpawnedActors)
+	{
+		if (SpawnedActor.IsValid())
+		{
+			DamageSubsystem->SubmitDamage(SpawnedActor.Get(), WaveLethalDamage, nullptr, nullptr);
+		}
+	}
+}
+
+void UGCBenchmarkSubsystem::FinishWaves()
+{
+	bIsRunningWaves = false;
+	WaveActorClass = nullptr;
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->EndCapture();
+#endif
+
+	UE_LOG(LogGCBenchmark, Display, TEXT("Waves benchmark finished | %d waves | average spawn: %.3f ms | average despawn: %.3f ms | worst frame: %.3f ms | capture: %s"),
+		WaveIndex, WaveSpawnTimeSum * 1000.0 / WaveIndex, WaveDespawnTimeSum * 1000.0 / WaveIndex, WorstWaveFrameTime * 1000.0, *(FPaths::ProfilingDir() / TEXT("GCBenchmark")));
+
+	CheckBudget(TEXT("Worst wave frame time, ms"), WorstWaveFrameTime * 1000.0, WaveFrameTimeBudgetMs);
+
+	bIsWaitingForCapture = true;
+}
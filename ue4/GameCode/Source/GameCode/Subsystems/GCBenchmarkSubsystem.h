@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GCBenchmarkSubsystem.generated.h"
+
+class ABasePlatform;
+class AGCAICharacter;
+class ATurret;
+
+/**
+ * Spawns a crowd of AI characters, turrets and moving platforms, steps the world for a fixed amount of frames and records a CSV capture of it.
+ * Headless run: UE4Editor GameCode Gym_Default -game -nullrhi -unattended -benchmark -fps=30 -ExecCmds="GCBenchmark 64 16 16 900 1"
+ * It's the project's performance baseline instead of an automation test module, the project keeps no test modules or targets.
+ * A run over the configured budgets logs an error and, when quitting, exits with code 1 so the headless run fails
+ * GCWavesBenchmark spawns, kills and despawns waves of AI characters and reports the hitches of it, compare runs with gc.EquipmentPool.Enabled 0 and 1
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UGCBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+protected:
+	UPROPERTY(Config)
+	TSoftClassPtr<AGCAICharacter> AICharacterClass;
+
+	UPROPERTY(Config)
+	TSoftClassPtr<ATurret> TurretClass;
+
+	// Should have a looping timeline set up, otherwise spawned platforms stay still
+	UPROPERTY(Config)
+	TSoftClassPtr<ABasePlatform> PlatformClass;
+
+	UPROPERTY(Config)
+	FVector SpawnOrigin = FVector::ZeroVector;
+
+	UPROPERTY(Config)
+	float SpawnSpacing = 400.0f;
+
+	// Budgets of a run, 0 turns a check off
+	UPROPERTY(Config)
+	float AverageFrameTimeBudgetMs = 33.3f;
+
+	// Growth of used physical memory from the start to the end of GCBenchmark
+	UPROPERTY(Config)
+	float AllocationBudgetMB = 256.0f;
+
+	UPROPERTY(Config)
+	float WaveFrameTimeBudgetMs = 100.0f;
+
+private:
+	UFUNCTION(exec)
+	void GCBenchmark(int32 AICharactersCount = 32, int32 TurretsCount = 8, int32 PlatformsCount = 16, int32 FramesCount = 600, bool bQuitWhenDone = false);
+
+	UFUNCTION(exec)
+	void GCWavesBenchmark(int32 WavesCount = 10, int32 WaveSize = 40, int32 FramesPerWave = 90, bool bQuitWhenDone = false);
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void SpawnBenchmarkActors(UClass* ActorClass, int32 Count, int32& SpawnIndex);
+	void DestroySpawnedActors();
+	void FinishBenchmark();
+	void CheckBudget(const TCHAR* BudgetName, double Value, float Budget);
+
+	void StartWave();
+	void UpdateWave();
+	void KillWave();
+	void FinishWaves();
+
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors;
+
+	int32 FramesLeft = 0;
+	int32 FramesRecorded = 0;
+	double FrameTimeSum = 0.0;
+	uint64 StartUsedPhysical = 0;
+	uint64 LastUsedPhysical = 0;
+	bool bIsRunning = false;
+	bool bIsWaitingForCapture = false;
+	bool bQuitOnFinish = false;
+	bool bIsOverBudget = false;
+
+	UPROPERTY(Transient)
+	UClass* WaveActorClass = nullptr;
+
+	int32 WavesLeft = 0;
+	int32 WaveCharactersCount = 0;
+	int32 WaveFramesCount = 0;
+	int32 WaveFrame = 0;
+	int32 WaveIndex = 0;
+	double WaveSpawnTime = 0.0;
+	double WaveMaxFrameTime = 0.0;
+	double WaveSpawnTimeSum = 0.0;
+	double WaveDespawnTimeSum = 0.0;
+	double WorstWaveFrameTime = 0.0;
+	bool bIsRunningWaves = false;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GCTickableWorldSubsystem.h"
+
+void UGCTickableWorldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	bIsInitialized = true;
+}
+
+void UGCTickableWorldSubsystem::Deinitialize()
+{
+	bIsInitialized = false;
+	Super::Deinitialize();
+}
+
+ETickableTickType UGCTickableWorldSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool UGCTickableWorldSubsystem::IsTickable() const
+{
+	return bIsInitialized;
+}
+
+TStatId UGCTickableWorldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGCTickableWorldSubsystem, STATGROUP_Tickables);
+}
+
+UWorld* UGCTickableWorldSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
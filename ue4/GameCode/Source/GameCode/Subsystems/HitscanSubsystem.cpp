@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanSubsystem.h"
+#include "GameCodeTypes.h"
+#include "Async/ParallelFor.h"
+#include "Components/Weapon/WeaponBarellComponent.h"
+#include "Utils/GCTelemetry.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan shots"), STAT_HitscanShots, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan trace batches"), STAT_HitscanTraceBatches, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Hitscan resolve"), STAT_HitscanResolve, STATGROUP_GameCode);
+
+static TAutoConsoleVariable<int32> CVarHitscanBatching(
+	TEXT("gc.Hitscan.Batching"),
+	1,
+	TEXT("0 - every shot traces inline when it is fired, 1 - shots are queued and traced in one batch at the end of the frame"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarHitscanParallelThreshold(
+	TEXT("gc.Hitscan.ParallelThreshold"),
+	8,
+	TEXT("Minimal amount of queued shots in a frame to spread the traces over worker threads"),
+	ECVF_Default);
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UHitscanSubsystem::OnWorldPostActorTick);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingShots.Empty();
+	ResolvingShots.Empty();
+	ShotResults.Empty();
+	Super::Deinitialize();
+}
+
+void UHitscanSubsystem::SubmitShot(const FHitscanShotRequest& ShotRequest)
+{
+	INC_DWORD_STAT(STAT_HitscanShots);
+
+	if (CVarHitscanBatching.GetValueOnGameThread() == 0)
+	{
+		ResolveShotImmediately(ShotRequest);
+		return;
+	}
+
+	PendingShots.Add(ShotRequest);
+}
+
+void UHitscanSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		ResolvePendingShots();
+	}
+}
+
+void UHitscanSubsystem::ResolvePendingShots()
+{
+	const int32 ShotsCount = PendingShots.Num();
+	if (ShotsCount == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_HitscanResolve);
+	CSV_SCOPED_TIMING_STAT(GameCode, Hitscan);
+	CSV_CUSTOM_STAT(GameCode, HitscanTraces, ShotsCount, ECsvCustomStatOp::Accumulate);
+	INC_DWORD_STAT(STAT_HitscanTraceBatches);
+
+	// Damage and FX can destroy actors or fire new shots, those go to the next frame.
+	// Both buffers keep their capacity, the one resolved last frame takes new shots
+	Swap(ResolvingShots, PendingShots);
+
+	UWorld* World = GetWorld();
+	ShotResults.SetNum(ShotsCount, false);
+
+	// Scene queries take the physics scene read lock themselves, so traces of independent shots can run side by side
+	const bool bForceSingleThread = ShotsCount < CVarHitscanParallelThreshold.GetValueOnGameThread();
+	ParallelFor(ShotsCount, [this, World](int32 Index)
+	{
+		const FHitscanShotRequest& ShotRequest = ResolvingShots[Index];
+		FHitResult& ShotResult = ShotResults[Index];
+		ShotResult = FHitResult();
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HitscanShot));
+		World->LineTraceSingleByChannel(ShotResult, ShotRequest.ShotStart, ShotRequest.ShotEnd, ECC_Bullet, QueryParams);
+		GCTelemetry::RecordEvent(ETelemetryEventType::Shot, ShotRequest.ShooterId, 0, ShotResult.bBlockingHit ? ShotResult.Distance : -1.0f, ShotRequest.ShotStart);
+	}, bForceSingleThread);
+
+	for (int32 i = 0; i < ShotsCount; ++i)
+	{
+		ApplyShotResult(ResolvingShots[i], ShotResults[i]);
+	}
+	ResolvingShots.Reset();
+	ShotResults.Reset();
+}
+
+void UHitscanSubsystem::ResolveShotImmediately(const FHitscanShotRequest& ShotRequest)
+{
+	CSV_SCOPED_TIMING_STAT(GameCode, Hitscan);
+	CSV_CUSTOM_STAT(GameCode, HitscanTraces, 1, ECsvCustomStatOp::Accumulate);
+	INC_DWORD_STAT(STAT_HitscanTraceBatches);
+
+	FHitResult ShotResult;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HitscanShot));
+	GetWorld()->LineTraceSingleByChannel(ShotResult, ShotRequest.ShotStart, ShotRequest.ShotEnd, ECC_Bullet, QueryParams);
+	GCTelemetry::RecordEvent(ETelemetryEventType::Shot, ShotRequest.ShooterId, 0, ShotResult.bBlockingHit ? ShotResult.Distance : -1.0f, ShotRequest.ShotStart);
+	ApplyShotResult(ShotRequest, ShotResult);
+}
+
+void UHitscanSubsystem::ApplyShotResult(const FHitscanShotRequest& ShotRequest, const FHitResult& ShotResult)
+{
+	if (ShotRequest.Barell.IsValid())
+	{
+		ShotRequest.Barell->ProcessShotResult(ShotRequest, ShotResult);
+	}
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HitscanSubsystem.generated.h"
+
+class UWeaponBarellComponent;
+struct FHitscanShotRequest
+{
+	TWeakObjectPtr<UWeaponBarellComponent> Barell;
+	TWeakObjectPtr<AController> Instigator;
+	// Unique id of the shooting actor, traces on worker threads report it without touching the actor
+	uint32 ShooterId = 0;
+
+	FVector MuzzleLocation = FVector::ZeroVector;
+	FRotator MuzzleRotation = FRotator::ZeroRotator;
+	FVector ShotStart = FVector::ZeroVector;
+	FVector ShotEnd = FVector::ZeroVector;
+};
+
+/**
+ * Collects hitscan shots fired during a frame and resolves them in one batch after actors have ticked
+ */
+UCLASS()
+class GAMECODE_API UHitscanSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void SubmitShot(const FHitscanShotRequest& ShotRequest);
+
+private:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void ResolvePendingShots();
+	void ResolveShotImmediately(const FHitscanShotRequest& ShotRequest);
+	void ApplyShotResult(const FHitscanShotRequest& ShotRequest, const FHitResult& ShotResult);
+
+	TArray<FHitscanShotRequest> PendingShots;
+	TArray<FHitscanShotRequest> ResolvingShots;
+	TArray<FHitResult> ShotResults;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ImpactFXSubsystem.h"
+#include "AssetStreamingSubsystem.h"
+#include "Components/DecalComponent.h"
+#include "Components/Weapon/WeaponBarellComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "NiagaraComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact FX recycled"), STAT_ImpactFXRecycled, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impact FX created"), STAT_ImpactFXCreated, STATGROUP_GameCode);
+
+static void PreparePooledComponent(UDecalComponent* Component)
+{
+	Component->SetFadeScreenSize(0.0001f);
+	Component->SetVisibility(false);
+}
+
+static void PreparePooledComponent(UNiagaraComponent* Component)
+{
+	Component->SetAutoActivate(false);
+	Component->SetAutoDestroy(false);
+}
+
+static void PreparePooledComponent(UParticleSystemComponent* Component)
+{
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+}
+
+static void ReleasePooledComponent(UDecalComponent* Component)
+{
+	Component->SetVisibility(false);
+}
+
+static void ReleasePooledComponent(UNiagaraComponent* Component)
+{
+	Component->DeactivateImmediate();
+}
+
+static void ReleasePooledComponent(UParticleSystemComponent* Component)
+{
+	Component->DeactivateSystem();
+}
+
+void UImpactFXSubsystem::Deinitialize()
+{
+	DestroyComponents(DecalPool);
+	for (TPair<UNiagaraSystem*, FImpactFXPool>& NiagaraPool : NiagaraPools)
+	{
+		DestroyComponents(NiagaraPool.Value);
+	}
+	for (TPair<UParticleSystem*, FImpactFXPool>& ParticlePool : ParticlePools)
+	{
+		DestroyComponents(ParticlePool.Value);
+	}
+	NiagaraPools.Empty();
+	ParticlePools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UImpactFXSubsystem::Tick(float DeltaTime)
+{
+	float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	ExpireComponents<UDecalComponent>(DecalPool, CurrentTime);
+	for (TPair<UNiagaraSystem*, FImpactFXPool>& NiagaraPool : NiagaraPools)
+	{
+		ExpireComponents<UNiagaraComponent>(NiagaraPool.Value, CurrentTime);
+	}
+	for (TPair<UParticleSystem*, FImpactFXPool>& ParticlePool : ParticlePools)
+	{
+		ExpireComponents<UParticleSystemComponent>(ParticlePool.Value, CurrentTime);
+	}
+}
+
+TStatId UImpactFXSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UImpactFXSubsystem, STATGROUP_GameCode);
+}
+
+void UImpactFXSubsystem::SpawnDecal(const FDecalInfo& DecalInfo, const FVector& Location, const FRotator& Rotation)
+{
+	UMaterialInterface* DecalMaterial = GCAssetStreaming::GetOrLoadAsset(DecalInfo.DecalMaterial);
+	if (!IsValid(DecalMaterial))
+	{
+		return;
+	}
+
+	// Fade out is rendered relative to the moment render state is recreated, the pool hides the decal once it's faded
+	UDecalComponent* DecalComponent = AcquireComponent<UDecalComponent>(DecalPool, DecalPoolCapacity, DecalInfo.DecalLifeTime + DecalInfo.DecalFadeOutTime);
+	DecalComponent->SetDecalMaterial(DecalMaterial);
+	DecalComponent->DecalSize = DecalInfo.DecalSize;
+	DecalComponent->SetWorldLocationAndRotation(Location, Rotation);
+	DecalComponent->SetFadeOut(DecalInfo.DecalLifeTime, DecalInfo.DecalFadeOutTime, false);
+	// SetFadeOut also sets a life span that destroys the component, pooled decals are only hidden on expiry
+	DecalComponent->SetLifeSpan(0.f);
+	DecalComponent->SetVisibility(true);
+	DecalComponent->MarkRenderStateDirty();
+}
+
+UNiagaraComponent* UImpactFXSubsystem::SpawnNiagaraSystem(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation)
+{
+	if (!IsValid(System))
+	{
+		return nullptr;
+	}
+
+	UNiagaraComponent* NiagaraComponent = AcquireComponent<UNiagaraComponent>(NiagaraPools.FindOrAdd(System), NiagaraPoolCapacity, NiagaraLifeTime);
+	if (NiagaraComponent->GetAsset() != System)
+	{
+		NiagaraComponent->SetAsset(System);
+	}
+	NiagaraComponent->SetWorldLocationAndRotation(Location, Rotation);
+	NiagaraComponent->Activate(true);
+	return NiagaraComponent;
+}
+
+void UImpactFXSubsystem::SpawnParticleSystem(UParticleSystem* Template, const FTransform& Transform)
+{
+	if (!IsValid(Template))
+	{
+		return;
+	}
+
+	UParticleSystemComponent* ParticleComponent = AcquireComponent<UParticleSystemComponent>(ParticlePools.FindOrAdd(Template), ParticlePoolCapacity, ParticleLifeTime);
+	if (ParticleComponent->Template != Template)
+	{
+		ParticleComponent->SetTemplate(Template);
+	}
+	ParticleComponent->SetWorldTransform(Transform);
+	ParticleComponent->ActivateSystem(true);
+}
+
+template<class TComponent>
+TComponent* UImpactFXSubsystem::AcquireComponent(FImpactFXPool& Pool, int32 Capacity, float LifeTime)
+{
+	// Clamp meta isn't applied to values read from ini, a pool always holds at least one component
+	int32 Index = INDEX_NONE;
+	if (Pool.Components.Num() < FMath::Max(Capacity, 1))
+	{
+		Index = Pool.Components.Add(nullptr);
+		Pool.ExpirationTimes.Add(0.0f);
+	}
+	else
+	{
+		Index = Pool.NextIndex;
+		Pool.NextIndex = (Pool.NextIndex + 1) % Pool.Components.Num();
+		INC_DWORD_STAT(STAT_ImpactFXRecycled);
+	}
+
+	TComponent* Component = Cast<TComponent>(Pool.Components[Index]);
+	if (!IsValid(Component))
+	{
+		Component = NewObject<TComponent>(GetWorld());
+		PreparePooledComponent(Component);
+		Component->RegisterComponentWithWorld(GetWorld());
+		Pool.Components[Index] = Component;
+		INC_DWORD_STAT(STAT_ImpactFXCreated);
+	}
+
+	Pool.ExpirationTimes[Index] = GetWorld()->GetTimeSeconds() + LifeTime;
+	return Component;
+}
+
+template<class TComponent>
+void UImpactFXSubsystem::ExpireComponents(FImpactFXPool& Pool, float CurrentTime)
+{
+	for (int32 i = 0; i < Pool.Components.Num(); ++i)
+	{
+		if (Pool.ExpirationTimes[i] > 0.0f && Pool.ExpirationTimes[i] <= CurrentTime)
+		{
+			Pool.ExpirationTimes[i] = 0.0f;
+			TComponent* Component = Cast<TComponent>(Pool.Components[i]);
+			if (IsValid(Component))
+			{
+				ReleasePooledComponent(Component);
+			}
+		}
+	}
+}
+
+void UImpactFXSubsystem::DestroyComponents(FImpactFXPool& Pool)
+{
+	for (USceneComponent* Component : Pool.Components)
+	{
+		if (IsValid(Component))
+		{
+			Component->DestroyComponent();
+		}
+	}
+	Pool.Components.Empty();
+	Pool.ExpirationTimes.Empty();
+	Pool.NextIndex = 0;
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GCTickableWorldSubsystem.h"
+#include "ImpactFXSubsystem.generated.h"
+
+USTRUCT()
+struct FImpactFXPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<USceneComponent*> Components;
+
+	TArray<float> ExpirationTimes;
+
+	// Index of the oldest entry once the pool reached its capacity
+	int32 NextIndex = 0;
+};
+
+struct FDecalInfo;
+class UDecalComponent;
+class UNiagaraSystem;
+class UNiagaraComponent;
+class UParticleSystem;
+class UParticleSystemComponent;
+/**
+ * Owns fixed-capacity ring pools of impact FX components. When a pool is full its oldest entry is recycled,
+ * entries are hidden by the pool itself once their lifetime is over
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UImpactFXSubsystem : public UGCTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void SpawnDecal(const FDecalInfo& DecalInfo, const FVector& Location, const FRotator& Rotation);
+	UNiagaraComponent* SpawnNiagaraSystem(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation);
+	void SpawnParticleSystem(UParticleSystem* Template, const FTransform& Transform);
+
+protected:
+	UPROPERTY(Config, meta = (ClampMin = 1, UIMin = 1))
+	int32 DecalPoolCapacity = 128;
+
+	UPROPERTY(Config, meta = (ClampMin = 1, UIMin = 1))
+	int32 NiagaraPoolCapacity = 32;
+
+	UPROPERTY(Config, meta = (ClampMin = 1, UIMin = 1))
+	int32 ParticlePoolCapacity = 8;
+
+	UPROPERTY(Config)
+	float NiagaraLifeTime = 2.0f;
+
+	UPROPERTY(Config)
+	float ParticleLifeTime = 5.0f;
+
+private:
+	template<class TComponent>
+	TComponent* AcquireComponent(FImpactFXPool& Pool, int32 Capacity, float LifeTime);
+
+	template<class TComponent>
+	void ExpireComponents(FImpactFXPool& Pool, float CurrentTime);
+
+	void DestroyComponents(FImpactFXPool& Pool);
+
+	UPROPERTY()
+	FImpactFXPool DecalPool;
+
+	UPROPERTY()
+	TMap<UNiagaraSystem*, FImpactFXPool> NiagaraPools;
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FImpactFXPool> ParticlePools;
+};
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractiveActorsSubsystem.h"
+#include "GameCodeTypes.h"
+#include "Actors/Interactive/InteractiveActor.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInteractiveActors, Display, Display)
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interactive actor queries"), STAT_InteractiveActorQueries, STATGROUP_GameCode);
+
+void UInteractiveActorsSubsystem::Deinitialize()
+{
+	Grids.Empty();
+	ActorsById.Empty();
+	Super::Deinitialize();
+}
+
+void UInteractiveActorsSubsystem::RegisterInteractiveActor(AInteractiveActor* InteractiveActor)
+{
+	FBox Bounds = InteractiveActor->GetInteractionBounds().ExpandBy(ReachMargin);
+	RegisteredBounds += Bounds;
+
+	// Ids are hashed from the stable path on every machine, probing to another id would depend on the registration order,
+	// so the second actor is kept out of the id lookup and can't be used in replicated moves
+	const TWeakObjectPtr<AInteractiveActor>* SameIdActor = ActorsById.Find(InteractiveActor->GetInteractiveActorId());
+	if (SameIdActor != nullptr && SameIdActor->IsValid() && SameIdActor->Get() != InteractiveActor)
+	{
+		UE_LOG(LogInteractiveActors, Error, TEXT("Interactive actor %s has the same id as %s, rename one of them"),
+			*InteractiveActor->GetPathName(), *GetPathNameSafe(SameIdActor->Get()));
+	}
+	else
+	{
+		ActorsById.Add(InteractiveActor->GetInteractiveActorId(), InteractiveActor);
+	}
+
+	TArray<FIntVector, TInlineAllocator<8>> Cells;
+	GetCells(Bounds, Cells);
+
+	FInteractiveActorsGrid& Grid = Grids.FindOrAdd(GetGridClass(InteractiveActor->GetClass()));
+	for (const FIntVector& Cell : Cells)
+	{
+		Grid.Cells.FindOrAdd(Cell).AddUnique(InteractiveActor);
+	}
+}
+
+void UInteractiveActorsSubsystem::UnregisterInteractiveActor(AInteractiveActor* InteractiveActor)
+{
+	if (ActorsById.FindRef(InteractiveActor->GetInteractiveActorId()) == InteractiveActor)
+	{
+		ActorsById.Remove(InteractiveActor->GetInteractiveActorId());
+	}
+
+	FInteractiveActorsGrid* Grid = Grids.Find(GetGridClass(InteractiveActor->GetClass()));
+	if (Grid == nullptr)
+	{
+		return;
+	}
+
+	TArray<FIntVector, TInlineAllocator<8>> Cells;
+	GetCells(InteractiveActor->GetInteractionBounds().ExpandBy(ReachMargin), Cells);
+	for (const FIntVector& Cell : Cells)
+	{
+		TArray<TWeakObjectPtr<AInteractiveActor>>* CellActors = Grid->Cells.Find(Cell);
+		if (CellActors != nullptr)
+		{
+			CellActors->RemoveSingleSwap(InteractiveActor);
+		}
+	}
+}
+
+const AInteractiveActor* UInteractiveActorsSubsystem::FindClosestInReach(UClass* InteractiveActorClass, const FInteractionReach& Reach) const
+{
+	INC_DWORD_STAT(STAT_InteractiveActorQueries);
+
+	const FInteractiveActorsGrid* Grid = Grids.Find(GetGridClass(InteractiveActorClass));
+	if (Grid == nullptr)
+	{
+		return nullptr;
+	}
+
+	const TArray<TWeakObjectPtr<AInteractiveActor>>* CellActors = Grid->Cells.Find(GetCell(Reach.Location));
+	if (CellActors == nullptr)
+	{
+		return nullptr;
+	}
+
+	const AInteractiveActor* Result = nullptr;
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (const TWeakObjectPtr<AInteractiveActor>& InteractiveActor : *CellActors)
+	{
+		if (!InteractiveActor.IsValid() || !InteractiveActor->IsInReach(Reach))
+		{
+			continue;
+		}
+
+		float DistanceSquared = FVector::DistSquared(InteractiveActor->GetInteractionBounds().GetCenter(), Reach.Location);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			Result = InteractiveActor.Get();
+		}
+	}
+	return Result;
+}
+
+const AInteractiveActor* UInteractiveActorsSubsystem::FindById(uint32 InteractiveActorId) const
+{
+	const TWeakObjectPtr<AInteractiveActor>* InteractiveActor = ActorsById.Find(InteractiveActorId);
+	return InteractiveActor != nullptr ? InteractiveActor->Get() : nullptr;
+}
+
+void UInteractiveActorsSubsystem::BenchmarkInteractiveActorQueries(int32 QueriesCount /*= 10000*/)
+{
+	if (!RegisteredBounds.IsValid || QueriesCount <= 0)
+	{
+		UE_LOG(LogInteractiveActors, Warning, TEXT("Interactive actors benchmark needs registered interactive actors"));
+		return;
+	}
+
+	const UCapsuleComponent* DefaultCapsule = GetDefault<ACharacter>()->GetCapsuleComponent();
+	float CapsuleRadius = DefaultCapsule->GetUnscaledCapsuleRadius();
+	float CapsuleHalfHeight = DefaultCapsule->GetUnscaledCapsuleHalfHeight();
+
+	TArray<FVector> SampleLocations;
+	SampleLocations.Reserve(QueriesCount);
+	FRandomStream RandomStream(QueriesCount);
+	for (int32 i = 0; i < QueriesCount; ++i)
+	{
+		SampleLocations.Add(RandomStream.RandPointInBox(RegisteredBounds));
+	}
+
+	// Overlap path is what every moving pawn capsule paid against interaction volumes
+	FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
+	FCollisionObjectQueryParams ObjectQueryParams(ECC_InteractionVolume);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(InteractiveActorsBenchmark));
+	TArray<FOverlapResult> Overlaps;
+	int32 OverlapsFound = 0;
+
+	double OverlapStartTime = FPlatformTime::Seconds();
+	for (const FVector& SampleLocation : SampleLocations)
+	{
+		Overlaps.Reset();
+		GetWorld()->OverlapMultiByObjectType(Overlaps, SampleLocation, FQuat::Identity, ObjectQueryParams, CapsuleShape, QueryParams);
+		OverlapsFound += Overlaps.Num();
+	}
+	double OverlapTime = FPlatformTime::Seconds() - OverlapStartTime;
+
+	int32 QueriesFound = 0;
+	double QueryStartTime = FPlatformTime::Seconds();
+	for (const FVector& SampleLocation : SampleLocations)
+	{
+		FInteractionReach Reach(SampleLocation, CapsuleRadius, CapsuleHalfHeight);
+		for (const TPair<UClass*, FInteractiveActorsGrid>& Grid : Grids)
+		{
+			QueriesFound += FindClosestInReach(Grid.Key, Reach) != nullptr ? 1 : 0;
+		}
+	}
+	double QueryTime = FPlatformTime::Seconds() - QueryStartTime;
+
+	UE_LOG(LogInteractiveActors, Display, TEXT("Interactive actors benchmark | %d samples | overlaps: %.3f ms, %d found | grid queries: %.3f ms, %d found"),
+		QueriesCount, OverlapTime * 1000.0, OverlapsFound, QueryTime * 1000.0, QueriesFound);
+}
+
+UClass* UInteractiveActorsSubsystem::GetGridClass(UClass* InteractiveActorClass) const
+{
+	UClass* Result = InteractiveActorClass;
+	while (IsValid(Result) && !Result->HasAnyClassFlags(CLASS_Native))
+	{
+		Result = Result->GetSuperClass();
+	}
+	return Result;
+}
+
+FIntVector UInteractiveActorsSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UInteractiveActorsSubsystem::GetCells(const FBox& Bounds, TArray<FIntVector, TInlineAllocator<8>>& OutCells) const
+{
+	FIntVector MinCell = GetCell(Bounds.Min);
+	FIntVector MaxCell = GetCell(Bounds.Max);
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				OutCells.Add(FIntVector(X, Y, Z));
+			}
+		}
+	}
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InteractiveActorsSubsystem.generated.h"
+
+class AInteractiveActor;
+struct FInteractionReach;
+struct FInteractiveActorsGrid
+{
+	TMap<FIntVector, TArray<TWeakObjectPtr<AInteractiveActor>>> Cells;
+};
+
+/**
+ * Uniform grid of interactive actors keyed by their native class. Characters query it on demand instead of collecting overlaps
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UInteractiveActorsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterInteractiveActor(AInteractiveActor* InteractiveActor);
+	void UnregisterInteractiveActor(AInteractiveActor* InteractiveActor);
+
+	const AInteractiveActor* FindClosestInReach(UClass* InteractiveActorClass, const FInteractionReach& Reach) const;
+
+	const AInteractiveActor* FindById(uint32 InteractiveActorId) const;
+
+	template<class T>
+	const T* FindClosestInReach(const FInteractionReach& Reach) const
+	{
+		return StaticCast<const T*>(FindClosestInReach(T::StaticClass(), Reach));
+	}
+
+protected:
+	UPROPERTY(Config)
+	float CellSize = 1000.0f;
+
+	// Actors are put in every cell their interaction bounds expanded by this margin touch, so a single cell lookup is enough
+	UPROPERTY(Config)
+	float ReachMargin = 200.0f;
+
+private:
+	UFUNCTION(exec)
+	void BenchmarkInteractiveActorQueries(int32 QueriesCount = 10000);
+
+	UClass* GetGridClass(UClass* InteractiveActorClass) const;
+	FIntVector GetCell(const FVector& Location) const;
+	void GetCells(const FBox& Bounds, TArray<FIntVector, TInlineAllocator<8>>& OutCells) const;
+
+	TMap<UClass*, FInteractiveActorsGrid> Grids;
+	TMap<uint32, TWeakObjectPtr<AInteractiveActor>> ActorsById;
+	FBox RegisteredBounds = FBox(ForceInit);
+};
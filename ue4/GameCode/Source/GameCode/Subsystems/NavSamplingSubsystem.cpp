@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NavSamplingSubsystem.h"
+#include "GameCodeTypes.h"
+#include "NavigationSystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav sample pool hits"), STAT_NavSamplePoolHits, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav sample pool misses"), STAT_NavSamplePoolMisses, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav samples"), STAT_NavSamples, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Nav sample pools refill"), STAT_NavSamplePoolsRefill, STATGROUP_GameCode);
+
+void UNavSamplingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UNavSamplingSubsystem::OnWorldPostActorTick);
+}
+
+void UNavSamplingSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (bIsBoundToNavigationSystem && IsValid(NavigationSystem))
+	{
+		NavigationSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UNavSamplingSubsystem::OnNavigationGenerationFinished);
+	}
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+bool UNavSamplingSubsystem::TryTakePoint(const AActor* Target, const FVector& TargetLocation, float Radius, FVector& OutPoint)
+{
+	FNavSamplePool& Pool = GetPool(Target, TargetLocation, Radius);
+	if (Pool.Points.Num() == 0)
+	{
+		INC_DWORD_STAT(STAT_NavSamplePoolMisses);
+		Pool.bNeedsRefill = true;
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_NavSamplePoolHits);
+	OutPoint = Pool.Points.Pop(false);
+	Pool.bNeedsRefill = Pool.Points.Num() == 0;
+	return true;
+}
+
+uint32 UNavSamplingSubsystem::RequestPoint(const AActor* Target, const FVector& TargetLocation, float Radius, const FOnNavPointSampled& Callback)
+{
+	FNavSamplePool& Pool = GetPool(Target, TargetLocation, Radius);
+	Pool.bNeedsRefill = true;
+
+	FNavSampleRequest& Request = Pool.PendingRequests.AddDefaulted_GetRef();
+	Request.RequestId = ++LastRequestId;
+	Request.Callback = Callback;
+	return Request.RequestId;
+}
+
+void UNavSamplingSubsystem::CancelRequest(uint32 RequestId)
+{
+	for (TPair<FNavSamplePoolKey, FNavSamplePool>& Pool : Pools)
+	{
+		int32 RemovedCount = Pool.Value.PendingRequests.RemoveAll([RequestId](const FNavSampleRequest& Request) { return Request.RequestId == RequestId; });
+		if (RemovedCount > 0)
+		{
+			return;
+		}
+	}
+}
+
+void UNavSamplingSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || Pools.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_NavSamplePoolsRefill);
+	CSV_SCOPED_TIMING_STAT(GameCode, NavSampling);
+
+	UNavigationSystemV1* NavigationSystem = GetNavigationSystem();
+	double CurrentTime = GetWorld()->GetTimeSeconds();
+	int32 RefillsLeft = MaxPoolRefillsPerFrame;
+	for (TMap<FNavSamplePoolKey, FNavSamplePool>::TIterator PoolIt = Pools.CreateIterator(); PoolIt; ++PoolIt)
+	{
+		FNavSamplePool& Pool = PoolIt.Value();
+		bool bIsExpired = !PoolIt.Key().Key.IsValid() || CurrentTime - Pool.LastUseTime > PoolLifetime;
+		if (bIsExpired && Pool.PendingRequests.Num() == 0)
+		{
+			PoolIt.RemoveCurrent();
+			continue;
+		}
+
+		if (!Pool.bNeedsRefill || RefillsLeft <= 0)
+		{
+			continue;
+		}
+		--RefillsLeft;
+		RefillPool(NavigationSystem, Pool);
+
+		for (FNavSampleRequest& Request : Pool.PendingRequests)
+		{
+			FNavSampleResult& Result = SampleResults.AddDefaulted_GetRef();
+			Result.Callback = MoveTemp(Request.Callback);
+			Result.bIsFound = Pool.Points.Num() > 0;
+			Result.Point = Result.bIsFound ? Pool.Points.Pop(false) : FVector::ZeroVector;
+		}
+		Pool.PendingRequests.Reset();
+		Pool.bNeedsRefill = false;
+	}
+
+	// Callbacks run after the pools are iterated, they may take points or queue requests again.
+	// Both buffers keep their capacity, the one run last frame collects new results
+	Swap(ExecutingResults, SampleResults);
+	for (FNavSampleResult& Result : ExecutingResults)
+	{
+		Result.Callback.ExecuteIfBound(Result.bIsFound, Result.Point);
+	}
+	ExecutingResults.Reset();
+}
+
+void UNavSamplingSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	for (TPair<FNavSamplePoolKey, FNavSamplePool>& Pool : Pools)
+	{
+		Pool.Value.Points.Reset();
+		Pool.Value.bNeedsRefill = true;
+	}
+}
+
+UNavigationSystemV1* UNavSamplingSubsystem::GetNavigationSystem()
+{
+	// Navigation system is created after world subsystems
+	UNavigationSystemV1* NavigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!bIsBoundToNavigationSystem && IsValid(NavigationSystem))
+	{
+		NavigationSystem->OnNavigationGenerationFinishedDelegate.AddDynamic(this, &UNavSamplingSubsystem::OnNavigationGenerationFinished);
+		bIsBoundToNavigationSystem = true;
+	}
+	return NavigationSystem;
+}
+
+FNavSamplePool& UNavSamplingSubsystem::GetPool(const AActor* Target, const FVector& TargetLocation, float Radius)
+{
+	FNavSamplePool& Pool = Pools.FindOrAdd(FNavSamplePoolKey(Target, FMath::RoundToInt(Radius)));
+	if (FVector::DistSquared(Pool.Origin, TargetLocation) > FMath::Square(InvalidationDistance))
+	{
+		Pool.Points.Reset();
+		Pool.bNeedsRefill = true;
+	}
+	if (Pool.bNeedsRefill)
+	{
+		Pool.Origin = TargetLocation;
+		Pool.Radius = Radius;
+	}
+	Pool.LastUseTime = GetWorld()->GetTimeSeconds();
+	return Pool;
+}
+
+void UNavSamplingSubsystem::RefillPool(UNavigationSystemV1* NavigationSystem, FNavSamplePool& Pool)
+{
+	Pool.Points.Reset();
+	if (!IsValid(NavigationSystem))
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_NavSamples, PointsPerPool);
+	for (int32 i = 0; i < PointsPerPool; ++i)
+	{
+		FNavLocation NavLocation;
+		if (NavigationSystem->GetRandomReachablePointInRadius(Pool.Origin, Pool.Radius, NavLocation))
+		{
+			Pool.Points.Add(NavLocation.Location);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NavSamplingSubsystem.generated.h"
+
+DECLARE_DELEGATE_TwoParams(FOnNavPointSampled, bool /*bIsFound*/, const FVector& /*Point*/);
+
+class ANavigationData;
+class UNavigationSystemV1;
+struct FNavSampleRequest
+{
+	uint32 RequestId = 0;
+	FOnNavPointSampled Callback;
+};
+
+struct FNavSampleResult
+{
+	FOnNavPointSampled Callback;
+	FVector Point = FVector::ZeroVector;
+	bool bIsFound = false;
+};
+
+struct FNavSamplePool
+{
+	FVector Origin = FVector::ZeroVector;
+	float Radius = 0.0f;
+	TArray<FVector> Points;
+	double LastUseTime = 0.0;
+	bool bNeedsRefill = true;
+
+	// Requests that found the pool empty, served right after the refill
+	TArray<FNavSampleRequest> PendingRequests;
+};
+
+/**
+ * Pools of reachable points around AI targets, refilled in a budgeted batch at the end of the frame.
+ * A pool is dropped when its target moves too far away from the pool origin and all pools are dropped on navmesh rebuild
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UNavSamplingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Takes a cached point around the target, false if there's none yet. The pool gets refilled in any case
+	bool TryTakePoint(const AActor* Target, const FVector& TargetLocation, float Radius, FVector& OutPoint);
+
+	// Queues a request served after the next refill of the target pool, returns its id
+	uint32 RequestPoint(const AActor* Target, const FVector& TargetLocation, float Radius, const FOnNavPointSampled& Callback);
+	void CancelRequest(uint32 RequestId);
+
+protected:
+	UPROPERTY(Config)
+	int32 PointsPerPool = 8;
+
+	UPROPERTY(Config)
+	int32 MaxPoolRefillsPerFrame = 4;
+
+	UPROPERTY(Config)
+	float InvalidationDistance = 200.0f;
+
+	// Pools nobody took a point from for this long are released
+	UPROPERTY(Config)
+	float PoolLifetime = 10.0f;
+
+private:
+	typedef TPair<TWeakObjectPtr<const AActor>, int32> FNavSamplePoolKey;
+
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	UNavigationSystemV1* GetNavigationSystem();
+	FNavSamplePool& GetPool(const AActor* Target, const FVector& TargetLocation, float Radius);
+	void RefillPool(UNavigationSystemV1* NavigationSystem, FNavSamplePool& Pool);
+
+	TMap<FNavSamplePoolKey, FNavSamplePool> Pools;
+	TArray<FNavSampleResult> SampleResults;
+	TArray<FNavSampleResult> ExecutingResults;
+
+	uint32 LastRequestId = 0;
+	bool bIsBoundToNavigationSystem = false;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PerceptionQuerySubsystem.h"
+#include "GameCodeTypes.h"
+#include "Async/ParallelFor.h"
+#include "AI/Controllers/GCAIController.h"
+#include "Perception/AIPerceptionComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception queries"), STAT_PerceptionQueries, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception snapshot actors"), STAT_PerceptionSnapshotActors, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Perception queries resolve"), STAT_PerceptionQueriesResolve, STATGROUP_GameCode);
+
+static TAutoConsoleVariable<int32> CVarPerceptionQueryParallelThreshold(
+	TEXT("gc.PerceptionQuery.ParallelThreshold"),
+	16,
+	TEXT("Minimal amount of queued closest target requests in a frame to resolve them on worker threads"),
+	ECVF_Default);
+
+void FPerceivedActorsSnapshot::Reset()
+{
+	Actors.Reset();
+	LocationsX.Reset();
+	LocationsY.Reset();
+	LocationsZ.Reset();
+	RangeBegins.Reset();
+	RangeEnds.Reset();
+	RequestFirstRanges.Reset();
+	RequestLocations.Reset();
+	ResultActorIndices.Reset();
+	ResultSenseIndices.Reset();
+}
+
+void UPerceptionQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UPerceptionQuerySubsystem::OnWorldPostActorTick);
+}
+
+void UPerceptionQuerySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PendingRequests.Empty();
+	ResolvingRequests.Empty();
+	PendingRequestIndices.Empty();
+	Super::Deinitialize();
+}
+
+void UPerceptionQuerySubsystem::RequestClosestSensedActor(AGCAIController* Controller, const TArray<TSubclassOf<UAISense>>& Senses)
+{
+	// Later request of the same controller in a frame replaces the earlier one, it's based on newer perception
+	int32* RequestIndex = PendingRequestIndices.Find(Controller);
+	FPerceptionQueryRequest& Request = RequestIndex != nullptr ? PendingRequests[*RequestIndex] : PendingRequests.AddDefaulted_GetRef();
+	if (RequestIndex == nullptr)
+	{
+		PendingRequestIndices.Add(Controller, PendingRequests.Num() - 1);
+	}
+
+	Request.Controller = Controller;
+	Request.Senses.Reset();
+	Request.Senses.Append(Senses);
+}
+
+void UPerceptionQuerySubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld() && PendingRequests.Num() > 0)
+	{
+		ResolvePendingRequests();
+	}
+}
+
+void UPerceptionQuerySubsystem::ResolvePendingRequests()
+{
+	SCOPE_CYCLE_COUNTER(STAT_PerceptionQueriesResolve);
+	CSV_SCOPED_TIMING_STAT(GameCode, PerceptionQuery);
+
+	// Controllers react to the results and may request again, those requests go to the next frame.
+	// Both buffers keep their capacity, the one resolved last frame takes new requests
+	Swap(ResolvingRequests, PendingRequests);
+	PendingRequestIndices.Reset();
+	const TArray<FPerceptionQueryRequest>& Requests = ResolvingRequests;
+
+	BuildSnapshot(Requests);
+	INC_DWORD_STAT_BY(STAT_PerceptionQueries, Requests.Num());
+	INC_DWORD_STAT_BY(STAT_PerceptionSnapshotActors, Snapshot.Actors.Num());
+
+	FPerceivedActorsSnapshot& Data = Snapshot;
+	Data.ResultActorIndices.SetNumUninitialized(Requests.Num());
+	Data.ResultSenseIndices.SetNumUninitialized(Requests.Num());
+
+	const bool bForceSingleThread = Requests.Num() < CVarPerceptionQueryParallelThreshold.GetValueOnGameThread();
+	ParallelFor(Requests.Num(), [&Data, &Requests](int32 RequestIndex)
+	{
+		const FVector& Origin = Data.RequestLocations[RequestIndex];
+		int32 ClosestActorIndex = INDEX_NONE;
+		int32 ClosestSenseIndex = INDEX_NONE;
+
+		int32 FirstRange = Data.RequestFirstRanges[RequestIndex];
+		for (int32 SenseIndex = 0; SenseIndex < Requests[RequestIndex].Senses.Num() && ClosestActorIndex == INDEX_NONE; ++SenseIndex)
+		{
+			float MinSquaredDistance = FLT_MAX;
+			for (int32 i = Data.RangeBegins[FirstRange + SenseIndex]; i < Data.RangeEnds[FirstRange + SenseIndex]; ++i)
+			{
+				float DX = Data.LocationsX[i] - Origin.X;
+				float DY = Data.LocationsY[i] - Origin.Y;
+				float DZ = Data.LocationsZ[i] - Origin.Z;
+				float SquaredDistance = DX * DX + DY * DY + DZ * DZ;
+				if (SquaredDistance < MinSquaredDistance)
+				{
+					MinSquaredDistance = SquaredDistance;
+					ClosestActorIndex = i;
+					ClosestSenseIndex = SenseIndex;
+				}
+			}
+		}
+
+		Data.ResultActorIndices[RequestIndex] = ClosestActorIndex;
+		Data.ResultSenseIndices[RequestIndex] = ClosestSenseIndex;
+	}, bForceSingleThread);
+
+	for (int32 RequestIndex = 0; RequestIndex < Requests.Num(); ++RequestIndex)
+	{
+		AGCAIController* Controller = Requests[RequestIndex].Controller.Get();
+		if (!IsValid(Controller))
+		{
+			continue;
+		}
+
+		int32 ActorIndex = Data.ResultActorIndices[RequestIndex];
+		AActor* ClosestActor = ActorIndex != INDEX_NONE ? Data.Actors[ActorIndex] : nullptr;
+		if (IsValid(ClosestActor))
+		{
+			Controller->OnClosestSensedActorResolved(ClosestActor, Requests[RequestIndex].Senses[Data.ResultSenseIndices[RequestIndex]]);
+		}
+		else
+		{
+			Controller->OnClosestSensedActorResolved(nullptr, nullptr);
+		}
+	}
+
+	Snapshot.Reset();
+	ResolvingRequests.Reset();
+}
+
+void UPerceptionQuerySubsystem::BuildSnapshot(const TArray<FPerceptionQueryRequest>& Requests)
+{
+	Snapshot.Reset();
+	Snapshot.RequestFirstRanges.Reserve(Requests.Num());
+	Snapshot.RequestLocations.Reserve(Requests.Num());
+
+	for (const FPerceptionQueryRequest& Request : Requests)
+	{
+		Snapshot.RequestFirstRanges.Add(Snapshot.RangeBegins.Num());
+
+		AGCAIController* Controller = Request.Controller.Get();
+		APawn* Pawn = IsValid(Controller) ? Controller->GetPawn() : nullptr;
+		UAIPerceptionComponent* PerceptionComponent = IsValid(Controller) ? Controller->GetPerceptionComponent() : nullptr;
+		Snapshot.RequestLocations.Add(IsValid(Pawn) ? Pawn->GetActorLocation() : FVector::ZeroVector);
+
+		for (const TSubclassOf<UAISense>& Sense : Request.Senses)
+		{
+			Snapshot.RangeBegins.Add(Snapshot.Actors.Num());
+			if (IsValid(Pawn) && IsValid(PerceptionComponent))
+			{
+				const FAISenseID SenseID = UAISense::GetSenseID(Sense);
+				for (UAIPerceptionComponent::TActorPerceptionContainer::TConstIterator DataIt = PerceptionComponent->GetPerceptualDataConstIterator(); DataIt; ++DataIt)
+				{
+					AActor* PerceivedActor = DataIt->Value.Target.Get();
+					if (IsValid(PerceivedActor) && DataIt->Value.IsSenseActive(SenseID))
+					{
+						FVector Location = PerceivedActor->GetActorLocation();
+						Snapshot.Actors.Add(PerceivedActor);
+						Snapshot.LocationsX.Add(Location.X);
+						Snapshot.LocationsY.Add(Location.Y);
+						Snapshot.LocationsZ.Add(Location.Z);
+					}
+				}
+			}
+			Snapshot.RangeEnds.Add(Snapshot.Actors.Num());
+		}
+	}
+}
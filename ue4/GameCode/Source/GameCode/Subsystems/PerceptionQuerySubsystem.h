@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Perception/AISense.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PerceptionQuerySubsystem.generated.h"
+
+class AGCAIController;
+struct FPerceptionQueryRequest
+{
+	TWeakObjectPtr<AGCAIController> Controller;
+
+	// Senses in priority order, the closest actor of the first sense perceiving anything wins
+	TArray<TSubclassOf<UAISense>, TInlineAllocator<2>> Senses;
+};
+
+/**
+ * Perceived actors of every requesting controller, captured once per frame. Locations are kept in separate arrays per axis
+ */
+struct FPerceivedActorsSnapshot
+{
+	TArray<AActor*> Actors;
+	TArray<float> LocationsX;
+	TArray<float> LocationsY;
+	TArray<float> LocationsZ;
+
+	// [RangeBegins[i], RangeEnds[i]) are the actors of one request sense, senses of a request are stored in a row starting at RequestFirstRanges
+	TArray<int32> RangeBegins;
+	TArray<int32> RangeEnds;
+	TArray<int32> RequestFirstRanges;
+	TArray<FVector> RequestLocations;
+
+	TArray<int32> ResultActorIndices;
+	TArray<int32> ResultSenseIndices;
+
+	void Reset();
+};
+
+/**
+ * Resolves "closest sensed actor" requests of all AI controllers in one batch at the end of the frame
+ */
+UCLASS()
+class GAMECODE_API UPerceptionQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void RequestClosestSensedActor(AGCAIController* Controller, const TArray<TSubclassOf<UAISense>>& Senses);
+
+private:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void ResolvePendingRequests();
+	void BuildSnapshot(const TArray<FPerceptionQueryRequest>& Requests);
+
+	TArray<FPerceptionQueryRequest> PendingRequests;
+	TArray<FPerceptionQueryRequest> ResolvingRequests;
+	TMap<TWeakObjectPtr<AGCAIController>, int32> PendingRequestIndices;
+
+	FPerceivedActorsSnapshot Snapshot;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TelemetrySubsystem.h"
+#include "Utils/GCTelemetry.h"
+
+void UTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	if (FParse::Param(FCommandLine::Get(), TEXT("gctelemetry")))
+	{
+		GCTelemetryStart();
+	}
+}
+
+void UTelemetrySubsystem::Deinitialize()
+{
+	GCTelemetry::StopRecording();
+	Super::Deinitialize();
+}
+
+void UTelemetrySubsystem::GCTelemetryStart()
+{
+	FString FilePath = FPaths::ProfilingDir() / TEXT("GCTelemetry") / FString::Printf(TEXT("GCTelemetry_%s.gctl"), *FDateTime::Now().ToString());
+	if (GCTelemetry::StartRecording(FilePath))
+	{
+		LastFilePath = FilePath;
+	}
+}
+
+void UTelemetrySubsystem::GCTelemetryStop()
+{
+	GCTelemetry::StopRecording();
+}
+
+void UTelemetrySubsystem::GCTelemetryToCsv(const FString& FileName)
+{
+	FString FilePath = FileName.IsEmpty() ? LastFilePath : FileName;
+	if (FPaths::GetPath(FilePath).IsEmpty())
+	{
+		FilePath = FPaths::ProfilingDir() / TEXT("GCTelemetry") / FilePath;
+	}
+
+	// The file is still being written while recording
+	if (FilePath == LastFilePath)
+	{
+		GCTelemetry::StopRecording();
+	}
+	GCTelemetry::ConvertToCsv(FilePath, FPaths::ChangeExtension(FilePath, TEXT("csv")));
+}
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "TelemetrySubsystem.generated.h"
+
+/**
+ * Records gameplay telemetry to Saved/Profiling/GCTelemetry, starts right away with -gctelemetry on the command line.
+ * The same events go to the GameCodeTelemetry trace channel, run with -trace=cpu,frame,bookmark,gamecodetelemetry to see them in Insights
+ */
+UCLASS()
+class GAMECODE_API UTelemetrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+private:
+	UFUNCTION(exec)
+	void GCTelemetryStart();
+
+	UFUNCTION(exec)
+	void GCTelemetryStop();
+
+	// Converts the last recorded file when no file name is given, a bare file name is looked up in the telemetry folder
+	UFUNCTION(exec)
+	void GCTelemetryToCsv(const FString& FileName);
+
+	FString LastFilePath;
+};
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TickSignificanceSubsystem.h"
+#include "GameCodeTypes.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Significance ticks saved"), STAT_SignificanceTicksSaved, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance full rate actors"), STAT_SignificanceFullActors, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance reduced rate actors"), STAT_SignificanceReducedActors, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance dormant actors"), STAT_SignificanceDormantActors, STATGROUP_GameCode);
+
+void UTickSignificanceSubsystem::Deinitialize()
+{
+	Entries.Empty();
+	Super::Deinitialize();
+}
+
+void UTickSignificanceSubsystem::Tick(float DeltaTime)
+{
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	CSV_SCOPED_TIMING_STAT(GameCode, TickSignificance);
+
+	EvaluationTimer -= DeltaTime;
+	if (EvaluationTimer <= 0.0f)
+	{
+		EvaluationTimer = EvaluationInterval;
+
+		FVector ViewLocation = FVector::ZeroVector;
+		bool bHasViewLocation = false;
+		APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+		if (IsValid(PlayerController) && IsValid(PlayerController->PlayerCameraManager))
+		{
+			ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+			bHasViewLocation = true;
+		}
+
+		for (int32 i = Entries.Num() - 1; i >= 0; --i)
+		{
+			AActor* Actor = Entries[i].Actor.Get();
+			if (!IsValid(Actor))
+			{
+				Entries.RemoveAtSwap(i);
+				continue;
+			}
+			ETickSignificanceBucket Bucket = EvaluateBucket(Actor, bHasViewLocation ? &ViewLocation : nullptr);
+			ApplyBucket(Entries[i], (ETickSignificanceBucket)FMath::Min((uint8)Bucket, (uint8)Entries[i].MaxBucket));
+		}
+	}
+
+	// Every tick function in a throttled bucket runs DeltaTime / Interval times per frame on average
+	float TicksSaved = 0.0f;
+	int32 BucketActorsCount[(uint8)ETickSignificanceBucket::MAX] = { 0 };
+	for (const FTickSignificanceEntry& Entry : Entries)
+	{
+		++BucketActorsCount[(uint8)Entry.Bucket];
+		float TickInterval = GetBucketTickInterval(Entry.Bucket);
+		if (TickInterval > 0.0f)
+		{
+			TicksSaved += (1 + Entry.Components.Num()) * (1.0f - FMath::Min(1.0f, DeltaTime / TickInterval));
+		}
+	}
+
+	SET_FLOAT_STAT(STAT_SignificanceTicksSaved, TicksSaved);
+	SET_DWORD_STAT(STAT_SignificanceFullActors, BucketActorsCount[(uint8)ETickSignificanceBucket::Full]);
+	SET_DWORD_STAT(STAT_SignificanceReducedActors, BucketActorsCount[(uint8)ETickSignificanceBucket::Reduced]);
+	SET_DWORD_STAT(STAT_SignificanceDormantActors, BucketActorsCount[(uint8)ETickSignificanceBucket::Dormant]);
+}
+
+TStatId UTickSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTickSignificanceSubsystem, STATGROUP_GameCode);
+}
+
+void UTickSignificanceSubsystem::RegisterActor(AActor* Actor, const TArray<UActorComponent*>& Components /*= TArray<UActorComponent*>()*/, ETickSignificanceBucket MaxBucket /*= ETickSignificanceBucket::Dormant*/)
+{
+	FTickSignificanceEntry Entry;
+	Entry.Actor = Actor;
+	Entry.MaxBucket = MaxBucket;
+	for (UActorComponent* Component : Components)
+	{
+		Entry.Components.Add(Component);
+	}
+	Entries.Add(Entry);
+}
+
+void UTickSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	Entries.RemoveAllSwap([Actor](const FTickSignificanceEntry& Entry) { return Entry.Actor.Get() == Actor; });
+}
+
+ETickSignificanceBucket UTickSignificanceSubsystem::EvaluateBucket(const AActor* Actor, const FVector* ViewLocation) const
+{
+	const APawn* Pawn = Cast<APawn>(Actor);
+	if (IsValid(Pawn) && Pawn->IsPlayerControlled())
+	{
+		return ETickSignificanceBucket::Full;
+	}
+
+	if (ViewLocation == nullptr || FVector::DistSquared(Actor->GetActorLocation(), *ViewLocation) < FMath::Square(NearDistance))
+	{
+		return ETickSignificanceBucket::Full;
+	}
+
+	return Actor->WasRecentlyRendered(VisibilityTolerance) ? ETickSignificanceBucket::Reduced : ETickSignificanceBucket::Dormant;
+}
+
+void UTickSignificanceSubsystem::ApplyBucket(FTickSignificanceEntry& Entry, ETickSignificanceBucket Bucket)
+{
+	if (Entry.Bucket == Bucket)
+	{
+		return;
+	}
+
+	Entry.Bucket = Bucket;
+	float TickInterval = GetBucketTickInterval(Bucket);
+	Entry.Actor->SetActorTickInterval(TickInterval);
+	for (const TWeakObjectPtr<UActorComponent>& Component : Entry.Components)
+	{
+		if (Component.IsValid())
+		{
+			Component->SetComponentTickInterval(TickInterval);
+		}
+	}
+}
+
+float UTickSignificanceSubsystem::GetBucketTickInterval(ETickSignificanceBucket Bucket) const
+{
+	switch (Bucket)
+	{
+		case ETickSignificanceBucket::Reduced:
+		{
+			return ReducedTickInterval;
+		}
+		case ETickSignificanceBucket::Dormant:
+		{
+			return DormantTickInterval;
+		}
+		case ETickSignificanceBucket::Full:
+		default:
+		{
+			return 0.0f;
+		}
+	}
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GCTickableWorldSubsystem.h"
+#include "TickSignificanceSubsystem.generated.h"
+
+UENUM()
+enum class ETickSignificanceBucket : uint8
+{
+	Full = 0,
+	Reduced,
+	Dormant,
+	MAX UMETA(Hidden)
+};
+
+struct FTickSignificanceEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+	TArray<TWeakObjectPtr<UActorComponent>, TInlineAllocator<2>> Components;
+	ETickSignificanceBucket Bucket = ETickSignificanceBucket::Full;
+	ETickSignificanceBucket MaxBucket = ETickSignificanceBucket::Dormant;
+};
+
+/**
+ * Groups registered actors into buckets by distance to the view and visibility and sets their tick intervals.
+ * Tick functions with an interval receive the time elapsed since their previous tick, so time based updates stay accurate
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UTickSignificanceSubsystem : public UGCTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Actors with gameplay state in their tick cap the bucket they may be throttled to with MaxBucket
+	void RegisterActor(AActor* Actor, const TArray<UActorComponent*>& Components = TArray<UActorComponent*>(), ETickSignificanceBucket MaxBucket = ETickSignificanceBucket::Dormant);
+	void UnregisterActor(AActor* Actor);
+
+protected:
+	UPROPERTY(Config)
+	float NearDistance = 2500.0f;
+
+	UPROPERTY(Config)
+	float ReducedTickInterval = 0.1f;
+
+	UPROPERTY(Config)
+	float DormantTickInterval = 1.0f;
+
+	UPROPERTY(Config)
+	float VisibilityTolerance = 0.2f;
+
+	UPROPERTY(Config)
+	float EvaluationInterval = 0.25f;
+
+private:
+	ETickSignificanceBucket EvaluateBucket(const AActor* Actor, const FVector* ViewLocation) const;
+	void ApplyBucket(FTickSignificanceEntry& Entry, ETickSignificanceBucket Bucket);
+	float GetBucketTickInterval(ETickSignificanceBucket Bucket) const;
+
+	TArray<FTickSignificanceEntry> Entries;
+	float EvaluationTimer = 0.0f;
+};
@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TurretAimSubsystem.h"
+#include "GameCodeTypes.h"
+#include "AI/Characters/Turret.h"
+#include "Subsystems/CombatSnapshotSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Turret transform writes"), STAT_TurretTransformWrites, STATGROUP_GameCode);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Turret transform writes skipped"), STAT_TurretTransformWritesSkipped, STATGROUP_GameCode);
+DECLARE_CYCLE_STAT(TEXT("Turret aim"), STAT_TurretAim, STATGROUP_GameCode);
+
+void FTurretAimState::RemoveAtSwap(int32 Index)
+{
+	Turrets.RemoveAtSwap(Index, 1, false);
+	Bases.RemoveAtSwap(Index, 1, false);
+	Barells.RemoveAtSwap(Index, 1, false);
+	SearchingRotationRates.RemoveAtSwap(Index, 1, false);
+	FiringInterpSpeeds.RemoveAtSwap(Index, 1, false);
+	PitchRotationRates.RemoveAtSwap(Index, 1, false);
+	Yaws.RemoveAtSwap(Index, 1, false);
+	Pitches.RemoveAtSwap(Index, 1, false);
+	WrittenYaws.RemoveAtSwap(Index, 1, false);
+	WrittenPitches.RemoveAtSwap(Index, 1, false);
+}
+
+void UTurretAimSubsystem::Deinitialize()
+{
+	TurretIndices.Empty();
+	Super::Deinitialize();
+}
+
+void UTurretAimSubsystem::Tick(float DeltaTime)
+{
+	if (State.Turrets.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_TurretAim);
+	CSV_SCOPED_TIMING_STAT(GameCode, TurretAim);
+
+	GatherTargets();
+	UpdateAim(DeltaTime);
+	WriteTransforms();
+}
+
+TStatId UTurretAimSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTurretAimSubsystem, STATGROUP_Tickables);
+}
+
+void UTurretAimSubsystem::RegisterTurret(ATurret* Turret, USceneComponent* Base, USceneComponent* Barell, const FTurretAimSettings& Settings)
+{
+	if (TurretIndices.Contains(Turret))
+	{
+		return;
+	}
+
+	TurretIndices.Add(Turret, State.Turrets.Num());
+	State.Turrets.Add(Turret);
+	State.Bases.Add(Base);
+	State.Barells.Add(Barell);
+	State.SearchingRotationRates.Add(Settings.SearchingRotationRate);
+	State.FiringInterpSpeeds.Add(Settings.FiringInterpSpeed);
+	State.PitchRotationRates.Add(Settings.PitchRotationRate);
+	State.Yaws.Add(Base->GetRelativeRotation().Yaw);
+	State.Pitches.Add(Barell->GetRelativeRotation().Pitch);
+	State.WrittenYaws.Add(State.Yaws.Last());
+	State.WrittenPitches.Add(State.Pitches.Last());
+}
+
+void UTurretAimSubsystem::UnregisterTurret(ATurret* Turret)
+{
+	int32 Index = INDEX_NONE;
+	if (!TurretIndices.RemoveAndCopyValue(Turret, Index))
+	{
+		return;
+	}
+
+	State.RemoveAtSwap(Index);
+	if (State.Turrets.IsValidIndex(Index))
+	{
+		TurretIndices[State.Turrets[Index]] = Index;
+	}
+}
+
+bool UTurretAimSubsystem::GetAimedTransform(const ATurret* Turret, const USceneComponent* BarellChild, FTransform& OutTransform) const
+{
+	const int32* Index = TurretIndices.Find(Turret);
+	if (Index == nullptr || BarellChild->GetAttachParent() != State.Barells[*Index])
+	{
+		return false;
+	}
+
+	const USceneComponent* Base = State.Bases[*Index];
+	const USceneComponent* Barell = State.Barells[*Index];
+	const USceneComponent* BaseParent = Base->GetAttachParent();
+	if (!IsValid(BaseParent))
+	{
+		return false;
+	}
+
+	FRotator BaseRotation = Base->GetRelativeRotation();
+	BaseRotation.Yaw = State.Yaws[*Index];
+	FRotator BarellRotation = Barell->GetRelativeRotation();
+	BarellRotation.Pitch = State.Pitches[*Index];
+
+	FTransform BaseTransform(BaseRotation, Base->GetRelativeLocation(), Base->GetRelativeScale3D());
+	FTransform BarellTransform(BarellRotation, Barell->GetRelativeLocation(), Barell->GetRelativeScale3D());
+	OutTransform = BarellChild->GetRelativeTransform() * BarellTransform * BaseTransform * BaseParent->GetComponentTransform();
+	return true;
+}
+
+void UTurretAimSubsystem::GatherTargets()
+{
+	const UCombatSnapshotSubsystem* CombatSnapshotSubsystem = GetWorld()->GetSubsystem<UCombatSnapshotSubsystem>();
+	const FCombatSnapshot& CombatSnapshot = CombatSnapshotSubsystem->GetSnapshot();
+
+	int32 TurretsCount = State.Turrets.Num();
+	State.Modes.SetNumUninitialized(TurretsCount);
+	State.TargetYaws.SetNumUninitialized(TurretsCount);
+	State.TargetPitches.SetNumUninitialized(TurretsCount);
+	State.bIsVisible.SetNumUninitialized(TurretsCount);
+	for (int32 i = 0; i < TurretsCount; ++i)
+	{
+		const ATurret* Turret = State.Turrets[i];
+		AActor* Target = Turret->GetCurrentTarget();
+		State.bIsVisible[i] = Turret->WasRecentlyRendered(VisibilityTolerance);
+		State.TargetYaws[i] = 0.0f;
+		State.TargetPitches[i] = 0.0f;
+
+		if (Turret->IsDestroyed())
+		{
+			State.Modes[i] = ETurretAimMode::Idle;
+			continue;
+		}
+		if (!Turret->IsFiring() || !IsValid(Target))
+		{
+			State.Modes[i] = ETurretAimMode::Searching;
+			continue;
+		}
+
+		// Target set during this frame isn't in the snapshot yet
+		int32 TargetIndex = CombatSnapshotSubsystem->FindIndex(Target);
+		FVector TargetLocation = TargetIndex != INDEX_NONE ? CombatSnapshot.Locations[TargetIndex] : Target->GetActorLocation();
+
+		FVector BaseToTarget = TargetLocation - State.Bases[i]->GetComponentLocation();
+		FVector BarellToTarget = TargetLocation - State.Barells[i]->GetComponentLocation();
+		State.Modes[i] = ETurretAimMode::Firing;
+		State.TargetYaws[i] = FMath::RadiansToDegrees(FMath::Atan2(BaseToTarget.Y, BaseToTarget.X)) - Turret->GetActorRotation().Yaw;
+		State.TargetPitches[i] = FMath::RadiansToDegrees(FMath::Atan2(BarellToTarget.Z, BarellToTarget.Size2D()));
+	}
+}
+
+void UTurretAimSubsystem::UpdateAim(float DeltaTime)
+{
+	// Plain float arrays without calls to the turrets, the compiler is free to vectorize it
+	int32 TurretsCount = State.Turrets.Num();
+	float* Yaws = State.Yaws.GetData();
+	float* Pitches = State.Pitches.GetData();
+	const float* TargetYaws = State.TargetYaws.GetData();
+	const float* TargetPitches = State.TargetPitches.GetData();
+	const ETurretAimMode* Modes = State.Modes.GetData();
+	for (int32 i = 0; i < TurretsCount; ++i)
+	{
+		float FiringAlpha = Modes[i] == ETurretAimMode::Firing ? 1.0f : 0.0f;
+		float SearchingAlpha = Modes[i] == ETurretAimMode::Searching ? 1.0f : 0.0f;
+
+		float YawInterpAlpha = FMath::Clamp(DeltaTime * State.FiringInterpSpeeds[i], 0.0f, 1.0f);
+		float YawDelta = FRotator::NormalizeAxis(TargetYaws[i] - Yaws[i]);
+		Yaws[i] = FRotator::NormalizeAxis(Yaws[i] + FiringAlpha * YawDelta * YawInterpAlpha + SearchingAlpha * State.SearchingRotationRates[i] * DeltaTime);
+
+		// Searching turret levels its barell
+		float PitchInterpAlpha = FMath::Clamp(DeltaTime * State.PitchRotationRates[i], 0.0f, 1.0f);
+		Pitches[i] += (FiringAlpha + SearchingAlpha) * (TargetPitches[i] - Pitches[i]) * PitchInterpAlpha;
+	}
+}
+
+void UTurretAimSubsystem::WriteTransforms()
+{
+	const float AngleTolerance = 1e-3f;
+	int32 WritesCount = 0;
+	int32 SkippedCount = 0;
+	for (int32 i = 0; i < State.Turrets.Num(); ++i)
+	{
+		bool bIsYawChanged = !FMath::IsNearlyEqual(State.Yaws[i], State.WrittenYaws[i], AngleTolerance);
+		bool bIsPitchChanged = !FMath::IsNearlyEqual(State.Pitches[i], State.WrittenPitches[i], AngleTolerance);
+		if (!bIsYawChanged && !bIsPitchChanged)
+		{
+			continue;
+		}
+
+		// Firing turret shoots along its barell, so it's aimed even when nobody sees it. Sight of the others goes through GetAimedTransform
+		if (!State.bIsVisible[i] && State.Modes[i] != ETurretAimMode::Firing)
+		{
+			++SkippedCount;
+			continue;
+		}
+
+		FRotator BarellRotation = State.Barells[i]->GetRelativeRotation();
+		BarellRotation.Pitch = State.Pitches[i];
+		if (bIsYawChanged)
+		{
+			// Barell goes with the base update, so the pair propagates to children once
+			State.Barells[i]->SetRelativeRotation_Direct(BarellRotation);
+			FRotator BaseRotation = State.Bases[i]->GetRelativeRotation();
+			BaseRotation.Yaw = State.Yaws[i];
+			State.Bases[i]->SetRelativeRotation(BaseRotation);
+		}
+		else
+		{
+			State.Barells[i]->SetRelativeRotation(BarellRotation);
+		}
+
+		State.WrittenYaws[i] = State.Yaws[i];
+		State.WrittenPitches[i] = State.Pitches[i];
+		++WritesCount;
+	}
+
+	INC_DWORD_STAT_BY(STAT_TurretTransformWrites, WritesCount);
+	INC_DWORD_STAT_BY(STAT_TurretTransformWritesSkipped, SkippedCount);
+	CSV_CUSTOM_STAT(GameCode, TurretTransformWrites, WritesCount, ECsvCustomStatOp::Set);
+}
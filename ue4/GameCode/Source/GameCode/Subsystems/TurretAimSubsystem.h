@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GCTickableWorldSubsystem.h"
+#include "TurretAimSubsystem.generated.h"
+
+class ATurret;
+struct FTurretAimSettings
+{
+	float SearchingRotationRate = 0.0f;
+	float FiringInterpSpeed = 0.0f;
+	float PitchRotationRate = 0.0f;
+};
+
+enum class ETurretAimMode : uint8
+{
+	Searching,
+	Firing,
+	Idle
+};
+
+/**
+ * Aim state of every registered turret. Base yaw is relative to the turret root, barell pitch is relative to the base
+ */
+struct FTurretAimState
+{
+	TArray<ATurret*> Turrets;
+	TArray<USceneComponent*> Bases;
+	TArray<USceneComponent*> Barells;
+
+	TArray<float> SearchingRotationRates;
+	TArray<float> FiringInterpSpeeds;
+	TArray<float> PitchRotationRates;
+
+	TArray<float> Yaws;
+	TArray<float> Pitches;
+	TArray<float> WrittenYaws;
+	TArray<float> WrittenPitches;
+
+	// Filled every frame before the aim pass
+	TArray<ETurretAimMode> Modes;
+	TArray<float> TargetYaws;
+	TArray<float> TargetPitches;
+	TArray<bool> bIsVisible;
+
+	void RemoveAtSwap(int32 Index);
+};
+
+/**
+ * Aims all turrets in one pass instead of a tick per turret. Every turret gets at most one transform update a frame,
+ * searching turrets nobody sees keep their aim state without touching components, ATurret reads its view from the aim state
+ */
+UCLASS(Config = Game)
+class GAMECODE_API UTurretAimSubsystem : public UGCTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterTurret(ATurret* Turret, USceneComponent* Base, USceneComponent* Barell, const FTurretAimSettings& Settings);
+	void UnregisterTurret(ATurret* Turret);
+
+	// World transform a component attached to the barell has with the current aim state, whether it's written or not
+	bool GetAimedTransform(const ATurret* Turret, const USceneComponent* BarellChild, FTransform& OutTransform) const;
+
+protected:
+	UPROPERTY(Config)
+	float VisibilityTolerance = 0.2f;
+
+private:
+	void GatherTargets();
+	void UpdateAim(float DeltaTime);
+	void WriteTransforms();
+
+	FTurretAimState State;
+	TMap<const ATurret*, int32> TurretIndices;
+};
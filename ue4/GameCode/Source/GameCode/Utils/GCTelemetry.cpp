@@ -0,0 +1,356 @@
+#include "GCTelemetry.h"
+#include "HAL/FileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/FileHelper.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "Trace/Trace.inl"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGCTelemetry, Display, Display)
+
+#if UE_TRACE_ENABLED
+UE_TRACE_CHANNEL(GameCodeTelemetryChannel)
+
+UE_TRACE_EVENT_BEGIN(GameCode, TelemetryEvent)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, SourceId)
+	UE_TRACE_EVENT_FIELD(uint32, TargetId)
+	UE_TRACE_EVENT_FIELD(float, Value)
+	UE_TRACE_EVENT_FIELD(float, LocationX)
+	UE_TRACE_EVENT_FIELD(float, LocationY)
+	UE_TRACE_EVENT_FIELD(float, LocationZ)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+UE_TRACE_EVENT_END()
+#endif
+
+namespace GCTelemetry
+{
+	const uint32 FileMagic = 0x4C544347; // GCTL
+	const uint32 FileVersion = 1;
+	const uint32 RingCapacityPowerOfTwo = 16;
+	const uint32 WriterIntervalMs = 50;
+	const int32 WriterBatchSize = 1024;
+
+	class FTelemetryWriter : public FRunnable
+	{
+	public:
+		FTelemetryWriter(FTelemetryEventRing& InRing, FArchive* InFileWriter)
+			: Ring(InRing), FileWriter(InFileWriter), WakeUpEvent(FPlatformProcess::GetSynchEventFromPool())
+		{
+			Batch.Reserve(WriterBatchSize);
+		}
+
+		virtual ~FTelemetryWriter() override
+		{
+			FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!bIsStopRequested.load(std::memory_order_acquire))
+			{
+				WriteEvents();
+				WakeUpEvent->Wait(WriterIntervalMs);
+			}
+			WriteEvents();
+			FileWriter->Flush();
+			return 0;
+		}
+
+		virtual void Stop() override
+		{
+			bIsStopRequested.store(true, std::memory_order_release);
+			WakeUpEvent->Trigger();
+		}
+
+		uint64 GetWrittenCount() const { return WrittenCount; }
+
+	private:
+		void WriteEvents()
+		{
+			FTelemetryEvent Event;
+			while (Ring.Dequeue(Event))
+			{
+				Batch.Add(Event);
+				if (Batch.Num() == WriterBatchSize)
+				{
+					FlushBatch();
+				}
+			}
+			FlushBatch();
+		}
+
+		void FlushBatch()
+		{
+			if (Batch.Num() > 0)
+			{
+				FileWriter->Serialize(Batch.GetData(), Batch.Num() * sizeof(FTelemetryEvent));
+				WrittenCount += Batch.Num();
+				Batch.Reset();
+			}
+		}
+
+		FTelemetryEventRing& Ring;
+		FArchive* FileWriter = nullptr;
+		FEvent* WakeUpEvent = nullptr;
+		TArray<FTelemetryEvent> Batch;
+		uint64 WrittenCount = 0;
+		std::atomic<bool> bIsStopRequested { false };
+	};
+
+	// The ring outlives recordings, producers that have just seen the recording flag may still write into it
+	TUniquePtr<FTelemetryEventRing> Ring;
+	std::atomic<bool> bIsRecording { false };
+	TUniquePtr<FTelemetryWriter> Writer;
+	TUniquePtr<FRunnableThread> WriterThread;
+	TUniquePtr<FArchive> FileWriter;
+	uint64 DroppedCountOnStart = 0;
+}
+
+FTelemetryEventRing::FTelemetryEventRing(uint32 CapacityPowerOfTwo)
+{
+	uint64 Capacity = 1ull << CapacityPowerOfTwo;
+	Cells = MakeUnique<FCell[]>(Capacity);
+	Mask = Capacity - 1;
+	for (uint64 i = 0; i < Capacity; ++i)
+	{
+		Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+	EnqueuePosition.store(0, std::memory_order_relaxed);
+	DequeuePosition.store(0, std::memory_order_relaxed);
+	DroppedCount.store(0, std::memory_order_relaxed);
+}
+
+bool FTelemetryEventRing::Enqueue(const FTelemetryEvent& Event)
+{
+	uint64 Position = EnqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		FCell& Cell = Cells[Position & Mask];
+		int64 Difference = (int64)Cell.Sequence.load(std::memory_order_acquire) - (int64)Position;
+		if (Difference == 0)
+		{
+			if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+			{
+				Cell.Event = Event;
+				Cell.Sequence.store(Position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (Difference < 0)
+		{
+			// The cell still holds an event from the previous lap, the ring is full
+			DroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			Position = EnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool FTelemetryEventRing::Dequeue(FTelemetryEvent& OutEvent)
+{
+	uint64 Position = DequeuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		FCell& Cell = Cells[Position & Mask];
+		int64 Difference = (int64)Cell.Sequence.load(std::memory_order_acquire) - (int64)(Position + 1);
+		if (Difference == 0)
+		{
+			if (DequeuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+			{
+				OutEvent = Cell.Event;
+				Cell.Sequence.store(Position + Mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (Difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			Position = DequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void GCTelemetry::RecordEvent(ETelemetryEventType Type, uint32 SourceId, uint32 TargetId, float Value, const FVector& Location)
+{
+	uint64 Cycles = FPlatformTime::Cycles64();
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(GameCode, TelemetryEvent, GameCodeTelemetryChannel)
+		<< TelemetryEvent.Cycle(Cycles)
+		<< TelemetryEvent.SourceId(SourceId)
+		<< TelemetryEvent.TargetId(TargetId)
+		<< TelemetryEvent.Value(Value)
+		<< TelemetryEvent.LocationX(Location.X)
+		<< TelemetryEvent.LocationY(Location.Y)
+		<< TelemetryEvent.LocationZ(Location.Z)
+		<< TelemetryEvent.Type((uint8)Type);
+#endif
+
+	// Deaths are rare enough to be bookmarks, they show up right on the timing view
+	if (Type == ETelemetryEventType::Death)
+	{
+		TRACE_BOOKMARK(TEXT("Death %u"), TargetId);
+	}
+
+	if (!bIsRecording.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	FTelemetryEvent Event;
+	Event.Cycles = Cycles;
+	Event.FrameNumber = GFrameCounter;
+	Event.SourceId = SourceId;
+	Event.TargetId = TargetId;
+	Event.Value = Value;
+	Event.LocationX = Location.X;
+	Event.LocationY = Location.Y;
+	Event.LocationZ = Location.Z;
+	Event.Type = Type;
+	FMemory::Memzero(Event.Padding);
+	Ring->Enqueue(Event);
+}
+
+void GCTelemetry::RecordEvent(ETelemetryEventType Type, const UObject* Source, const UObject* Target, float Value, const FVector& Location)
+{
+	RecordEvent(Type, IsValid(Source) ? Source->GetUniqueID() : 0, IsValid(Target) ? Target->GetUniqueID() : 0, Value, Location);
+}
+
+bool GCTelemetry::IsRecording()
+{
+	return bIsRecording.load(std::memory_order_acquire);
+}
+
+bool GCTelemetry::StartRecording(const FString& FilePath)
+{
+	check(IsInGameThread());
+	if (IsRecording())
+	{
+		return false;
+	}
+
+	FileWriter.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!FileWriter.IsValid())
+	{
+		UE_LOG(LogGCTelemetry, Warning, TEXT("Can't open telemetry file %s"), *FilePath);
+		return false;
+	}
+
+	FTelemetryFileHeader Header;
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.EventSize = sizeof(FTelemetryEvent);
+	Header.Padding = 0;
+	Header.StartCycles = FPlatformTime::Cycles64();
+	Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	FileWriter->Serialize(&Header, sizeof(Header));
+
+	if (!Ring.IsValid())
+	{
+		Ring = MakeUnique<FTelemetryEventRing>(RingCapacityPowerOfTwo);
+	}
+
+	// Whatever late producers left after the previous recording doesn't belong to this file
+	FTelemetryEvent StaleEvent;
+	while (Ring->Dequeue(StaleEvent))
+	{
+	}
+	DroppedCountOnStart = Ring->GetDroppedCount();
+
+	Writer = MakeUnique<FTelemetryWriter>(*Ring, FileWriter.Get());
+	WriterThread.Reset(FRunnableThread::Create(Writer.Get(), TEXT("GCTelemetryWriter"), 0, TPri_BelowNormal));
+	bIsRecording.store(true, std::memory_order_release);
+
+	UE_LOG(LogGCTelemetry, Display, TEXT("Telemetry recording started | %s"), *FilePath);
+	return true;
+}
+
+void GCTelemetry::StopRecording()
+{
+	check(IsInGameThread());
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	bIsRecording.store(false, std::memory_order_release);
+	WriterThread->Kill(true);
+	WriterThread.Reset();
+
+	UE_LOG(LogGCTelemetry, Display, TEXT("Telemetry recording stopped | %llu events written, %llu dropped"),
+		Writer->GetWrittenCount(), Ring->GetDroppedCount() - DroppedCountOnStart);
+
+	Writer.Reset();
+	FileWriter->Close();
+	FileWriter.Reset();
+}
+
+bool GCTelemetry::ConvertToCsv(const FString& FilePath, const FString& CsvFilePath)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *FilePath) || FileData.Num() < sizeof(FTelemetryFileHeader))
+	{
+		UE_LOG(LogGCTelemetry, Warning, TEXT("Can't read telemetry file %s"), *FilePath);
+		return false;
+	}
+
+	FTelemetryFileHeader Header;
+	FMemory::Memcpy(&Header, FileData.GetData(), sizeof(Header));
+	if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.EventSize != sizeof(FTelemetryEvent))
+	{
+		UE_LOG(LogGCTelemetry, Warning, TEXT("%s is not a telemetry file of version %u"), *FilePath, FileVersion);
+		return false;
+	}
+
+	int32 EventsCount = (FileData.Num() - sizeof(Header)) / sizeof(FTelemetryEvent);
+	FString Csv;
+	Csv.Reserve((EventsCount + 1) * 96);
+	Csv += TEXT("Time,Frame,Type,SourceId,TargetId,Value,X,Y,Z\n");
+
+	for (int32 i = 0; i < EventsCount; ++i)
+	{
+		FTelemetryEvent Event;
+		FMemory::Memcpy(&Event, FileData.GetData() + sizeof(Header) + i * sizeof(FTelemetryEvent), sizeof(Event));
+		double Time = (double)(int64)(Event.Cycles - Header.StartCycles) * Header.SecondsPerCycle;
+		Csv += FString::Printf(TEXT("%.6f,%llu,%s,%u,%u,%.3f,%.1f,%.1f,%.1f\n"), Time, Event.FrameNumber, GetEventTypeName(Event.Type),
+			Event.SourceId, Event.TargetId, Event.Value, Event.LocationX, Event.LocationY, Event.LocationZ);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvFilePath))
+	{
+		UE_LOG(LogGCTelemetry, Warning, TEXT("Can't write %s"), *CsvFilePath);
+		return false;
+	}
+
+	UE_LOG(LogGCTelemetry, Display, TEXT("Telemetry converted | %d events | %s"), EventsCount, *CsvFilePath);
+	return true;
+}
+
+const TCHAR* GCTelemetry::GetEventTypeName(ETelemetryEventType Type)
+{
+	static const TCHAR* EventTypeNames[] =
+	{
+		TEXT("Shot"),
+		TEXT("Hit"),
+		TEXT("Damage"),
+		TEXT("Death"),
+		TEXT("MantleStart"),
+		TEXT("MantleEnd"),
+		TEXT("LadderAttach"),
+		TEXT("LadderDetach"),
+		TEXT("ZiplineAttach"),
+		TEXT("ZiplineDetach"),
+		TEXT("WallRunStart"),
+		TEXT("WallRunEnd")
+	};
+	static_assert(UE_ARRAY_COUNT(EventTypeNames) == (int32)ETelemetryEventType::Max, "Every telemetry event type needs a name");
+
+	return (uint8)Type < (uint8)ETelemetryEventType::Max ? EventTypeNames[(uint8)Type] : TEXT("Unknown");
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+enum class ETelemetryEventType : uint8
+{
+	Shot,
+	Hit,
+	Damage,
+	Death,
+	MantleStart,
+	MantleEnd,
+	LadderAttach,
+	LadderDetach,
+	ZiplineAttach,
+	ZiplineDetach,
+	WallRunStart,
+	WallRunEnd,
+	Max
+};
+
+// Fixed size record, it's copied as is into the ring and then into the file
+struct FTelemetryEvent
+{
+	uint64 Cycles;
+	uint64 FrameNumber;
+	uint32 SourceId;
+	uint32 TargetId;
+	float Value;
+	float LocationX;
+	float LocationY;
+	float LocationZ;
+	ETelemetryEventType Type;
+	uint8 Padding[7];
+};
+static_assert(TIsPODType<FTelemetryEvent>::Value, "Telemetry events are written to the file as raw memory");
+
+struct FTelemetryFileHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 EventSize;
+	uint32 Padding;
+	uint64 StartCycles;
+	double SecondsPerCycle;
+};
+
+/**
+ * Bounded multi producer multi consumer queue, every cell has a sequence number telling whose turn it is to use the cell.
+ * Producers never wait, an event is dropped when the ring is full
+ */
+class FTelemetryEventRing
+{
+public:
+	explicit FTelemetryEventRing(uint32 CapacityPowerOfTwo);
+
+	bool Enqueue(const FTelemetryEvent& Event);
+	bool Dequeue(FTelemetryEvent& OutEvent);
+
+	uint64 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+private:
+	struct FCell
+	{
+		std::atomic<uint64> Sequence;
+		FTelemetryEvent Event;
+	};
+
+	TUniquePtr<FCell[]> Cells;
+	uint64 Mask = 0;
+
+	// Producers and the consumer move different positions, padding keeps them off each other's cache line
+	uint8 Padding0[PLATFORM_CACHE_LINE_SIZE];
+	std::atomic<uint64> EnqueuePosition;
+	uint8 Padding1[PLATFORM_CACHE_LINE_SIZE - sizeof(std::atomic<uint64>)];
+	std::atomic<uint64> DequeuePosition;
+	uint8 Padding2[PLATFORM_CACHE_LINE_SIZE - sizeof(std::atomic<uint64>)];
+	std::atomic<uint64> DroppedCount;
+};
+
+namespace GCTelemetry
+{
+	// Safe to call from any thread, ids are object unique ids so events of one actor can be matched in the file
+	void RecordEvent(ETelemetryEventType Type, uint32 SourceId, uint32 TargetId, float Value, const FVector& Location);
+	void RecordEvent(ETelemetryEventType Type, const UObject* Source, const UObject* Target, float Value, const FVector& Location);
+
+	bool IsRecording();
+	bool StartRecording(const FString& FilePath);
+	void StopRecording();
+
+	bool ConvertToCsv(const FString& FilePath, const FString& CsvFilePath);
+	const TCHAR* GetEventTypeName(ETelemetryEventType Type);
+}
@@ -1,16 +1,24 @@
 #include "DrawDebugHelpers.h"
 #include "GCTraceUtils.h"
+#include "GameCodeTypes.h"
 
 bool GCTraceUtils::SweepCapsuleSingleByChannel(const UWorld* World, struct FHitResult& OutHit, const FVector& Start, const FVector& End, float CapsuleRadius, float CapsuleHalfHeight, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /*= FCollisionQueryParams::DefaultQueryParam*/, const FCollisionResponseParams& ResponseParam /*= FCollisionResponseParams::DefaultResponseParam*/, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor TraceColor /*= FColor::Black*/, FColor HitColor /*= FColor::Red*/)
+{
+	return SweepCapsuleSingleByChannel(World, OutHit, Start, End, FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), Rot, TraceChannel, Params, ResponseParam, bDrawDebug, DrawTime, TraceColor, HitColor);
+}
+
+bool GCTraceUtils::SweepCapsuleSingleByChannel(const UWorld* World, struct FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionShape& CapsuleShape, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /*= FCollisionQueryParams::DefaultQueryParam*/, const FCollisionResponseParams& ResponseParam /*= FCollisionResponseParams::DefaultResponseParam*/, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor TraceColor /*= FColor::Black*/, FColor HitColor /*= FColor::Red*/)
 {
 	bool bResult = false;
 
-	FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
-	bResult = World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, CollisionShape, Params, ResponseParam);
+	CSV_CUSTOM_STAT(GameCode, MovementTraces, 1, ECsvCustomStatOp::Accumulate);
+	bResult = World->SweepSingleByChannel(OutHit, Start, End, Rot, TraceChannel, CapsuleShape, Params, ResponseParam);
 
 #if ENABLE_DRAW_DEBUG
 	if (bDrawDebug)
 	{
+		float CapsuleRadius = CapsuleShape.GetCapsuleRadius();
+		float CapsuleHalfHeight = CapsuleShape.GetCapsuleHalfHeight();
 		DrawDebugCapsule(World, Start, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, TraceColor, false, DrawTime);
 		DrawDebugCapsule(World, End, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, TraceColor, false, DrawTime);
 		DrawDebugLine(World, Start, End, TraceColor, false, DrawTime);
@@ -27,15 +35,21 @@ bool GCTraceUtils::SweepCapsuleSingleByChannel(const UWorld* World, struct FHitR
 }
 
 bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* World, struct FHitResult& OutHit, const FVector& Start, const FVector& End, float SphereRadius, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /*= FCollisionQueryParams::DefaultQueryParam*/, const FCollisionResponseParams& ResponseParam /*= FCollisionResponseParams::DefaultResponseParam*/, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor TraceColor /*= FColor::Black*/, FColor HitColor /*= FColor::Red*/)
+{
+	return SweepSphereSingleByChannel(World, OutHit, Start, End, FCollisionShape::MakeSphere(SphereRadius), TraceChannel, Params, ResponseParam, bDrawDebug, DrawTime, TraceColor, HitColor);
+}
+
+bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* World, struct FHitResult& OutHit, const FVector& Start, const FVector& End, const FCollisionShape& SphereShape, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /*= FCollisionQueryParams::DefaultQueryParam*/, const FCollisionResponseParams& ResponseParam /*= FCollisionResponseParams::DefaultResponseParam*/, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor TraceColor /*= FColor::Black*/, FColor HitColor /*= FColor::Red*/)
 {
 	bool bResult = false;
 
-	FCollisionShape CollisionShape = FCollisionShape::MakeSphere(SphereRadius);
-	bResult = World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, TraceChannel, CollisionShape, Params, ResponseParam);
+	CSV_CUSTOM_STAT(GameCode, MovementTraces, 1, ECsvCustomStatOp::Accumulate);
+	bResult = World->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, TraceChannel, SphereShape, Params, ResponseParam);
 
 #if ENABLE_DRAW_DEBUG
 	if (bDrawDebug)
 	{
+		float SphereRadius = SphereShape.GetSphereRadius();
 		FVector CapsuleLocation = (Start + End) * 0.5f;
 		FVector TraceVector = End - Start;
 		float CapsuleHalfHeight = TraceVector.Size() * 0.5f;
@@ -55,16 +69,21 @@ bool GCTraceUtils::SweepSphereSingleByChannel(const UWorld* World, struct FHitRe
 }
 
 bool GCTraceUtils::OverlapCapsuleAnyByProfile(const UWorld* World, const FVector& Pos, float CapsuleRadius, float CapsuleHalfHeight, FQuat Rotation, FName ProfileName, const FCollisionQueryParams& QueryParams, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor HitColor /*= FColor::Red*/)
+{
+	return OverlapCapsuleAnyByProfile(World, Pos, FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), Rotation, ProfileName, QueryParams, bDrawDebug, DrawTime, HitColor);
+}
+
+bool GCTraceUtils::OverlapCapsuleAnyByProfile(const UWorld* World, const FVector& Pos, const FCollisionShape& CapsuleShape, FQuat Rotation, FName ProfileName, const FCollisionQueryParams& QueryParams, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor HitColor /*= FColor::Red*/)
 {
 	bool bResult = false;
 
-	FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
-	bResult = World->OverlapAnyTestByProfile(Pos, Rotation, ProfileName, CollisionShape, QueryParams);
+	CSV_CUSTOM_STAT(GameCode, MovementTraces, 1, ECsvCustomStatOp::Accumulate);
+	bResult = World->OverlapAnyTestByProfile(Pos, Rotation, ProfileName, CapsuleShape, QueryParams);
 
 #if ENABLE_DRAW_DEBUG
 	if (bDrawDebug && bResult)
 	{
-		DrawDebugCapsule(World, Pos, CapsuleHalfHeight, CapsuleRadius, Rotation, HitColor, false, DrawTime);
+		DrawDebugCapsule(World, Pos, CapsuleShape.GetCapsuleHalfHeight(), CapsuleShape.GetCapsuleRadius(), Rotation, HitColor, false, DrawTime);
 	}
 #endif
 
@@ -72,16 +91,21 @@ bool GCTraceUtils::OverlapCapsuleAnyByProfile(const UWorld* World, const FVector
 }
 
 bool GCTraceUtils::OverlapCapsuleBlockingByProfile(const UWorld* World, const FVector& Pos, float CapsuleRadius, float CapsuleHalfHeight, FQuat Rotation, FName ProfileName, const FCollisionQueryParams& QueryParams, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor HitColor /*= FColor::Red*/)
+{
+	return OverlapCapsuleBlockingByProfile(World, Pos, FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), Rotation, ProfileName, QueryParams, bDrawDebug, DrawTime, HitColor);
+}
+
+bool GCTraceUtils::OverlapCapsuleBlockingByProfile(const UWorld* World, const FVector& Pos, const FCollisionShape& CapsuleShape, FQuat Rotation, FName ProfileName, const FCollisionQueryParams& QueryParams, bool bDrawDebug /*= false*/, float DrawTime /*= -1.0f*/, FColor HitColor /*= FColor::Red*/)
 {
 	bool bResult = false;
 
-	FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight);
-	bResult = World->OverlapBlockingTestByProfile(Pos, Rotation, ProfileName, CollisionShape, QueryParams);
+	CSV_CUSTOM_STAT(GameCode, MovementTraces, 1, ECsvCustomStatOp::Accumulate);
+	bResult = World->OverlapBlockingTestByProfile(Pos, Rotation, ProfileName, CapsuleShape, QueryParams);
 
 #if ENABLE_DRAW_DEBUG
 	if (bDrawDebug && bResult)
 	{
-		DrawDebugCapsule(World, Pos, CapsuleHalfHeight, CapsuleRadius, Rotation, HitColor, false, DrawTime);
+		DrawDebugCapsule(World, Pos, CapsuleShape.GetCapsuleHalfHeight(), CapsuleShape.GetCapsuleRadius(), Rotation, HitColor, false, DrawTime);
 	}
 #endif
 